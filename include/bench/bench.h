@@ -0,0 +1,94 @@
+/**
+ * \file bench.h
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Kernel microbenchmarks
+ */
+#ifndef H_BENCH
+#define H_BENCH
+
+#include <kernel/stdint.h>
+
+/** Stack size of the benchmark task in bytes */
+#define BENCH_STACK_SIZE (512)
+
+/** Parameter of results that have none */
+#define BENCH_NO_PARAM (-1)
+
+/** Result of a memory block operation benchmark */
+typedef struct
+{
+	const char *name;           /**< Benchmarked function, suffixed with
+	                                 _unaligned if misalign is not 0 */
+	unsigned int size;          /**< Number of bytes processed per call */
+	unsigned int misalign;      /**< Source misalignment in bytes */
+	uint32_t cycles;            /**< Best number of cycles per call */
+	uint32_t bytes_per_kcycle;  /**< Throughput in bytes per 1000 cycles */
+} bench_string_result;
+
+/** Memory block operation results, filled by bench_string() */
+extern bench_string_result bench_string_results[];
+
+/** Number of entries in #bench_string_results */
+extern const unsigned int bench_string_nb_results;
+
+/** Set once all benchmarks have run, results can then be inspected */
+extern volatile int bench_done;
+
+/**
+ * Get a cycle timestamp for benchmarks
+ * \return Current value of the timestamp counter, see
+ * clock_get_timestamp_freq() for its frequency
+ */
+uint32_t bench_get_cycles(void);
+
+/**
+ * Report a result as a JSON line on the host console, when semihosting is
+ * available. Example:
+ * {"bench":"string","case":"memcpy","param":64,"value":93,"unit":"cycles"}
+ * \param[in] bench Benchmark name
+ * \param[in] name Case name
+ * \param[in] param Case parameter (e.g. a size), #BENCH_NO_PARAM for none
+ * \param[in] value Measured value
+ * \param[in] unit Unit of the measured value
+ */
+void bench_report(const char *bench, const char *name, int param,
+                  uint32_t value, const char *unit);
+
+/**
+ * Benchmark memcpy, memmove, memset and memcmp for each size class
+ * \retval 0 Success
+ * \retval #ENOMEM Unable to allocate the test buffers
+ */
+int bench_string(void);
+
+/**
+ * Benchmark context switches between two tasks and yields with no other task
+ * to switch to
+ * \retval 0 Success
+ * \retval #ENOMEM Unable to create the partner task
+ */
+int bench_sched(void);
+
+/**
+ * Benchmark kmalloc and kfree on heaps with increasing numbers of free blocks
+ * \retval 0 Success
+ * \retval #ENOMEM Unable to allocate the blocks fragmenting the heap
+ */
+int bench_kalloc(void);
+
+/**
+ * Benchmark the dispatch of a software-triggered IRQ to its handler
+ * \retval 0 Success
+ * \retval #EBUSY The IRQ used by the benchmark is already registered
+ * \retval #ENOTSUP The IRQ cannot be triggered (hosted port)
+ */
+int bench_irq(void);
+
+/**
+ * Benchmark task routine, runs all benchmarks then exits. With semihosting,
+ * the emulator or debugger session is stopped once done.
+ * \param[in] arg Unused
+ */
+void bench_main(void *arg);
+
+#endif
@@ -0,0 +1,31 @@
+/**
+ * \file cpu_dwt.h
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Data watchpoint and trace unit interface (cycle counter)
+ */
+#ifndef H_CPU_DWT
+#define H_CPU_DWT
+
+#include <kernel/stdint.h>
+
+/**
+ * Start the cycle counter
+ * \retval 0 Success
+ * \retval #ENOTSUP The core has no cycle counter
+ */
+int dwt_cyccnt_enable(void);
+
+/**
+ * Check if the cycle counter is running
+ * \return True if dwt_cyccnt_enable() succeeded, false otherwise
+ */
+int dwt_cyccnt_is_enabled(void);
+
+/**
+ * Get the current value of the cycle counter
+ * \return The number of core cycles elapsed since the counter was started,
+ * modulo 2^32
+ */
+uint32_t dwt_get_cyccnt(void);
+
+#endif
@@ -84,6 +84,9 @@
 /*
  * Core peripherals
  */
+/** Data watchpoint and trace unit base address */
+#define CPU_DWT_BASE (CPU_PPB_INT_START + 0x1000)
+
 /** System timer base address */
 #define CPU_SYSTMR_BASE (CPU_PPB_INT_START + 0xE010)
 
@@ -93,7 +96,13 @@
 /** System control block base address */
 #define CPU_SCB_BASE (CPU_PPB_INT_START + 0xED00)
 
+/** MPU base address */
+#define CPU_MPU_BASE (CPU_PPB_INT_START + 0xED90)
+
 /** MPU type register address */
-#define CPU_MPU_TYPE_REG ((unsigned int *)(CPU_PPB_INT_START + 0xED90))
+#define CPU_MPU_TYPE_REG ((unsigned int *)(CPU_MPU_BASE))
+
+/** Debug exception and monitor control register address */
+#define CPU_DEMCR_REG ((volatile unsigned int *)(CPU_PPB_INT_START + 0xEDFC))
 
 #endif
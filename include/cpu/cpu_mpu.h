@@ -0,0 +1,139 @@
+/**
+ * \file cpu_mpu.h
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Memory protection unit interface
+ */
+#ifndef H_CPU_MPU
+#define H_CPU_MPU
+
+#include <kernel/ramfunc.h>
+#include <kernel/stdint.h>
+#include <kernel/stddef.h>
+
+/*
+ * Region attributes, to be combined with a binary OR
+ */
+/** Instruction fetches are forbidden in the region */
+#define MPU_ATTR_XN (1U << 28)
+
+/** No access allowed */
+#define MPU_ATTR_AP_NONE (0U << 24)
+
+/** Read/write access for privileged code only */
+#define MPU_ATTR_AP_PRIV_RW (1U << 24)
+
+/** Read/write access for privileged code, read-only for unprivileged code */
+#define MPU_ATTR_AP_PRIV_RW_USER_RO (2U << 24)
+
+/** Read/write access for everyone */
+#define MPU_ATTR_AP_RW (3U << 24)
+
+/** Read-only access for privileged code only */
+#define MPU_ATTR_AP_PRIV_RO (5U << 24)
+
+/** Read-only access for everyone */
+#define MPU_ATTR_AP_RO (6U << 24)
+
+/** Normal memory, shareable, write-through cacheable (internal SRAM) */
+#define MPU_ATTR_SRAM ((1U << 18) | (1U << 17))
+
+/** Normal memory, non-shareable, write-through cacheable (internal flash) */
+#define MPU_ATTR_FLASH (1U << 17)
+
+/** Shareable device memory (peripherals) */
+#define MPU_ATTR_DEVICE (1U << 16)
+
+/**
+ * Disable subregions. Each region is divided into 8 subregions of equal size,
+ * accesses to a disabled subregion are handled as if the region did not exist.
+ * \param[in] mask Bit i set to disable subregion i
+ */
+#define MPU_ATTR_SRD(mask) ((((uint32_t)(mask)) & 0xFFU) << 8)
+
+/** Number of subregions in a region */
+#define MPU_NB_SUBREGIONS (8)
+
+/** Smallest region size supported by the MPU in bytes */
+#define MPU_MIN_REGION_SIZE (32U)
+
+/** Smallest region size supporting subregions in bytes */
+#define MPU_MIN_SUBREGION_REGION_SIZE (256U)
+
+/**
+ * Precomputed region register values, which can be loaded with
+ * mpu_region_load() without any further computation
+ */
+typedef struct
+{
+	uint32_t rbar;     /**< Region base address register value */
+	uint32_t rasr;     /**< Region attribute and size register value */
+} mpu_region_t;
+
+/**
+ * Get the number of regions supported by the MPU
+ * \return The number of MPU regions, 0 if there is no MPU
+ */
+int mpu_get_nb_regions(void);
+
+/**
+ * Compute the register values describing a region
+ * \param[in] region Number of the region
+ * \param[in] base Base address of the region
+ * \param[in] size Size of the region in bytes
+ * \param[in] attr Region attributes (MPU_ATTR_* flags)
+ * \param[out] r Set to the computed register values
+ * \retval 0 Success
+ * \retval #EINVAL Invalid region number, or size is not a power of 2 greater
+ * than or equal to #MPU_MIN_REGION_SIZE, or base is not aligned on size
+ */
+int mpu_region_compute(int region, void *base, size_t size, uint32_t attr,
+                       mpu_region_t *r);
+
+/**
+ * Load precomputed region values in the MPU
+ * \param[in] r Region values computed by mpu_region_compute()
+ * \note This function does not perform any check so that it is cheap enough to
+ * be called on context switch
+ */
+void mpu_region_load(const mpu_region_t *r) RAMFUNC;
+
+/**
+ * Setup and enable a region
+ * \param[in] region Number of the region
+ * \param[in] base Base address of the region
+ * \param[in] size Size of the region in bytes
+ * \param[in] attr Region attributes (MPU_ATTR_* flags)
+ * \retval 0 Success
+ * \retval #EINVAL Invalid parameters (see mpu_region_compute())
+ */
+int mpu_region_setup(int region, void *base, size_t size, uint32_t attr);
+
+/**
+ * Disable a region
+ * \param[in] region Number of the region
+ * \retval 0 Success
+ * \retval #EINVAL Invalid region number
+ */
+int mpu_region_disable(int region);
+
+/**
+ * Enable the MPU. Privileged code keeps the default memory map for addresses
+ * that are not covered by any region.
+ * \retval 0 Success
+ * \retval #ENODEV There is no MPU
+ */
+int mpu_enable(void);
+
+/**
+ * Disable the MPU
+ * \retval 0 Success
+ */
+int mpu_disable(void);
+
+/**
+ * Check if the MPU is enabled
+ * \return True if the MPU is enabled, false otherwise
+ */
+int mpu_is_enabled(void);
+
+#endif
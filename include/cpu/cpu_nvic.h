@@ -11,6 +11,7 @@
  * \param[in] irq Number of the interrupt to enable
  * \retval 0 Success
  * \retval #EINVAL Invalid IRQ number
+ * \retval #ENOTSUP No NVIC (hosted port)
  */
 int nvic_irq_enable(int irq);
 
@@ -19,6 +20,7 @@ int nvic_irq_enable(int irq);
  * \param[in] irq Number of the interrupt to disable
  * \retval 0 Success
  * \retval #EINVAL Invalid IRQ number
+ * \retval #ENOTSUP No NVIC (hosted port)
  */
 int nvic_irq_disable(int irq);
 
@@ -27,7 +29,17 @@ int nvic_irq_disable(int irq);
  * \param[in] irq Number of the interrupt flag to clear
  * \retval 0 Success
  * \retval #EINVAL Invalid IRQ number
+ * \retval #ENOTSUP No NVIC (hosted port)
  */
 int nvic_irq_clear(int irq);
 
+/**
+ * Set an interrupt pending flag, triggering the interrupt from software
+ * \param[in] irq Number of the interrupt to trigger
+ * \retval 0 Success
+ * \retval #EINVAL Invalid IRQ number
+ * \retval #ENOTSUP No NVIC (hosted port)
+ */
+int nvic_irq_set_pending(int irq);
+
 #endif
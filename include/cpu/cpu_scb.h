@@ -6,6 +6,7 @@
 #ifndef H_CPU_SCB
 #define H_CPU_SCB
 
+#include <kernel/ramfunc.h>
 #include <kernel/stdint.h>
 
 /** CPU identification */
@@ -34,7 +35,7 @@ int scb_get_cpuid(cpuid_t *cpuid);
  * Set PendSV interrupt pending bit
  * \retval 0 Success
  */
-int scb_set_pendSV(void);
+int scb_set_pendSV(void) RAMFUNC;
 
 /**
  * Clear PendSV interrupt pending bit
@@ -48,6 +49,12 @@ int scb_clear_pendSV(void);
  */
 int scb_clear_systick(void);
 
+/**
+ * Check if the SysTick interrupt is pending
+ * \return True if SysTick is pending, false otherwise
+ */
+int scb_is_systick_pending(void) RAMFUNC;
+
 /**
  * Request a system reset
  * \retval 0 Success
@@ -68,6 +75,14 @@ int scb_set_deep_sleep(int status);
  */
 int scb_set_trap_on_div_by_zero(int status);
 
+/**
+ * Enable or disable the memory management fault exception. When disabled, MPU
+ * faults escalate to hard faults.
+ * \param[in] status Set to 1 to enable the exception, 0 to disable
+ * \retval 0 Success
+ */
+int scb_set_mem_manage_fault(int status);
+
 /** Causes of faults */
 typedef enum
 {
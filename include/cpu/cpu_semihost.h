@@ -0,0 +1,25 @@
+/**
+ * \file cpu_semihost.h
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * ARM semihosting interface, to talk to a debugger or an emulator
+ *
+ * Semihosting calls trap through a BKPT instruction: without a debugger or an
+ * emulator to catch it, the core locks up. Only build it in images meant to
+ * run under one.
+ */
+#ifndef H_CPU_SEMIHOST
+#define H_CPU_SEMIHOST
+
+/**
+ * Write a string on the host console
+ * \param[in] s The null-terminated string to write
+ */
+void semihost_write0(const char *s);
+
+/**
+ * Report the end of the application to the host, which stops the emulation
+ * \param[in] status Exit status, 0 for success
+ */
+void semihost_exit(int status) __attribute__((noreturn));
+
+#endif
@@ -0,0 +1,39 @@
+/**
+ * \file cpu_string.h
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * CPU-specific memory block operations
+ */
+#ifndef H_CPU_STRING
+#define H_CPU_STRING
+
+#include <kernel/stddef.h>
+#include <kernel/stdint.h>
+
+/** Number of bytes moved by a single burst */
+#define CPU_BURST_SIZE (32)
+
+/**
+ * Copy memory by bursts, from lowest to highest addresses
+ * \param[out] dest Destination pointer, must be word-aligned
+ * \param[in] src Source pointer, must be word-aligned
+ * \param[in] n Number of bytes to copy, must be a multiple of #CPU_BURST_SIZE
+ */
+void cpu_copy_burst(void *dest, const void *src, size_t n);
+
+/**
+ * Copy memory by bursts, from highest to lowest addresses
+ * \param[out] dest_end End of the destination area, must be word-aligned
+ * \param[in] src_end End of the source area, must be word-aligned
+ * \param[in] n Number of bytes to copy, must be a multiple of #CPU_BURST_SIZE
+ */
+void cpu_copy_burst_backward(void *dest_end, const void *src_end, size_t n);
+
+/**
+ * Fill memory with a word by bursts
+ * \param[out] dest Destination pointer, must be word-aligned
+ * \param[in] word Value stored in every word of the area
+ * \param[in] n Number of bytes to fill, must be a multiple of #CPU_BURST_SIZE
+ */
+void cpu_fill_burst(void *dest, uint32_t word, size_t n);
+
+#endif
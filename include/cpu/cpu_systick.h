@@ -6,6 +6,12 @@
 #ifndef H_CPU_SYSTICK
 #define H_CPU_SYSTICK
 
+#include <kernel/ramfunc.h>
+#include <kernel/stdint.h>
+
+/** Mask of the SysTick current value, which is a 24-bit down-counter */
+#define SYSTICK_VAL_MASK (0x00FFFFFFU)
+
 /**
  * Configure the SysTick timer
  * \param[in] freq Desired timer interrupt frequency
@@ -33,4 +39,31 @@ int systick_disable(void);
  */
 unsigned int systick_get_freq(void);
 
+/**
+ * Get the frequency of the clock driving the SysTick counter
+ * \return The counter clock frequency in Hz, 0 if SysTick is not configured
+ */
+unsigned int systick_get_clock_freq(void);
+
+/**
+ * Get the number of counter clock cycles in a SysTick period
+ * \return The SysTick period in counter cycles, 0 if SysTick is not
+ * configured
+ */
+uint32_t systick_get_period(void);
+
+/**
+ * Start the SysTick timer as a free-running counter on the AHB clock, with
+ * the longest period and no interrupt. Used to timestamp early boot, it is
+ * reconfigured by systick_setup().
+ * \retval 0 Success
+ */
+int systick_start_counter(void);
+
+/**
+ * Get the current value of the SysTick down-counter
+ * \return The current counter value, between 0 and the reload value
+ */
+uint32_t systick_get_val(void) RAMFUNC;
+
 #endif
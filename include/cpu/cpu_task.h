@@ -6,25 +6,27 @@
 #ifndef H_CPU_TASK
 #define H_CPU_TASK
 
+#include <kernel/ramfunc.h>
+
 /**
  * Create a new task context
  * \param[in] sp Task stack pointer
  * \param[in] func Task entry point
  * \param[in] arg Task function parameter
  * \param[in] stop_func Function to call when task terminates
- * \return The new stack pointer
+ * \return The new stack pointer, NULL if the context could not be created
  */
 void * cpu_task_create_context(void *sp, void *func, void *arg, void *stop_func);
 
 /**
  * Save task context on PSP
  */
-void cpu_task_save_context(void);
+void cpu_task_save_context(void) RAMFUNC;
 
 /**
  * Restore task context from PSP
  */
-void cpu_task_restore_context(void);
+void cpu_task_restore_context(void) RAMFUNC;
 
 /**
  * Return to user mode
@@ -26,6 +26,39 @@ int cpu_irq_enable(void);
  */
 int cpu_irq_disable(void);
 
+/** Number of buckets of the interrupt-masked duration histogram */
+#define CPU_IRQOFF_NB_BUCKETS (32)
+
+/** Statistics of the sections run with IRQs disabled */
+typedef struct
+{
+	uint32_t count;         /**< Number of sections */
+	uint32_t max_cycles;    /**< Duration of the longest section */
+	void *max_site;         /**< Caller of cpu_irq_disable() which started
+	                             the longest section */
+	/** Number of sections by log2 of their duration */
+	uint32_t histogram[CPU_IRQOFF_NB_BUCKETS];
+} cpu_irqoff_stats;
+
+/**
+ * Start, or restart from scratch, recording the duration of sections run
+ * with IRQs disabled. Durations are core cycles counted by the DWT cycle
+ * counter, which is started if needed.
+ * \retval 0 Success
+ * \retval #ENOTSUP Statistics are not compiled in (IRQOFF_STATS=1), or the
+ * core has no cycle counter
+ */
+int cpu_irqoff_reset_stats(void);
+
+/**
+ * Get the statistics of the sections run with IRQs disabled
+ * \param[out] stats The statistics
+ * \retval 0 Success
+ * \retval #EINVAL stats is NULL
+ * \retval #ENOTSUP Statistics are not compiled in (IRQOFF_STATS=1)
+ */
+int cpu_irqoff_get_stats(cpu_irqoff_stats *stats);
+
 /** Data memory barrier */
 void cpu_dmb(void);
 
@@ -50,6 +83,14 @@ uint32_t cpu_read_psr(void);
  */
 void cpu_set_privilege(unsigned int priv);
 
+/**
+ * Check if the caller runs privileged, in handler mode or in privileged thread
+ * mode. Unprivileged code can neither mask IRQs nor access the system control
+ * space (SysTick, SCB, DWT).
+ * \return True if the caller is privileged, false otherwise
+ */
+int cpu_is_privileged(void);
+
 /**
  * Get the value of the MSP
  * \return Current value of the main stack pointer
@@ -64,6 +105,25 @@ void cpu_set_privilege(unsigned int priv);
 		_sp;                                                           \
 	})
 
+#ifdef CONFIG_HOSTED
+/** Emulated process stack pointer of the hosted port */
+extern void *cpu_psp;
+
+/**
+ * Get the value of the PSP
+ * \return Current value of the process stack pointer
+ */
+#define CPU_GET_PSP() (cpu_psp)
+
+/**
+ * Set the value of the PSP
+ * \param[in] sp New value of the process stack pointer
+ */
+#define CPU_SET_PSP(sp)                                                        \
+	do{                                                                    \
+		cpu_psp = (sp);                                                \
+	} while(0)
+#else
 /**
  * Get the value of the PSP
  * \return Current value of the process stack pointer
@@ -91,6 +151,7 @@ void cpu_set_privilege(unsigned int priv);
 		    : "r" (sp)                                                 \
 		);                                                             \
 	} while(0)
+#endif
 
 /**
  * Set the value of the MSP
@@ -106,6 +167,12 @@ void cpu_set_privilege(unsigned int priv);
 		);                                                             \
 	} while(0)
 
+/**
+ * Flag of the EXC_RETURN value (LR on exception entry) set when the frame was
+ * stacked on the process stack
+ */
+#define CPU_EXC_RETURN_PSP (1U << 2)
+
 /** Structure representing the frame stacked by hardware on exception entry */
 typedef struct
 {
@@ -0,0 +1,58 @@
+/**
+ * \file boot.h
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Boot timeline API
+ */
+#ifndef H_BOOT
+#define H_BOOT
+
+#include <kernel/stdint.h>
+
+/** Phases of kernel_entry(), in execution order */
+typedef enum
+{
+	BOOT_PHASE_SECTIONS,    /**< .data, .ramfunc and .bss initialization */
+	BOOT_PHASE_CLOCK,       /**< Clock tree setup */
+	BOOT_PHASE_KALLOC,      /**< Memory allocator initialization */
+	BOOT_PHASE_PROTECT,     /**< Memory protection setup */
+	BOOT_PHASE_SCHED,       /**< Scheduler initialization */
+	BOOT_NB_PHASES          /**< Number of boot phases */
+} boot_phase;
+
+/** Duration of a boot phase */
+typedef struct
+{
+	uint32_t cycles;        /**< Duration in core cycles */
+	uint32_t us;            /**< Duration in microseconds */
+} boot_phase_time;
+
+/**
+ * Start timing the boot, must be the first thing done by kernel_entry()
+ * \note It only relies on .noinit variables, so it can run before sections
+ * are initialized
+ */
+void boot_timer_start(void);
+
+/**
+ * Record the end of a boot phase, which started at the end of the previous
+ * one. Phases must be shorter than 2^24 cycles (233ms at 72MHz).
+ * \param[in] phase The boot phase that just ended
+ */
+void boot_mark(boot_phase phase);
+
+/**
+ * Get the duration of a boot phase
+ * \param[in] phase The boot phase
+ * \param[out] t Duration of the phase
+ * \retval 0 Success
+ * \retval #EINVAL Invalid phase or NULL pointer
+ */
+int boot_get_phase_time(boot_phase phase, boot_phase_time *t);
+
+/**
+ * Get the duration of all recorded boot phases
+ * \return Time spent in kernel_entry() before scheduling, in microseconds
+ */
+uint32_t boot_get_total_us(void);
+
+#endif
@@ -0,0 +1,75 @@
+/**
+ * \file clock.h
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Monotonic clock API
+ *
+ * The clock counts SysTick periods in 64 bits and interpolates within the
+ * current period with the SysTick counter. Readers never disable interrupts:
+ * the tick count is published through two alternating copies and a sequence
+ * number, and a SysTick interrupt that is pending but not handled yet is
+ * accounted for.
+ */
+#ifndef H_CLOCK
+#define H_CLOCK
+
+#include <kernel/ramfunc.h>
+#include <kernel/stdint.h>
+
+/**
+ * Initialize the clock from the current SysTick configuration, must be called
+ * after systick_setup() and before the SysTick interrupt is enabled. It also
+ * starts the DWT cycle counter, if any, for timestamps.
+ * \retval 0 Success
+ * \retval #EINVAL SysTick is not configured
+ */
+int clock_init(void);
+
+/**
+ * Account for a new SysTick period, must be the first thing done by the
+ * SysTick handler
+ */
+void clock_tick(void) RAMFUNC;
+
+/**
+ * Get the number of SysTick periods since the clock was started
+ * \return The tick count
+ * \note Unlike other getters, this one can be used by unprivileged tasks
+ */
+uint64_t clock_get_ticks(void) RAMFUNC;
+
+/**
+ * Get the number of SysTick counter cycles since the clock was started
+ * \return The cycle count, at the resolution of the SysTick counter clock
+ * \note Interrupts with a higher priority than SysTick must not use the clock
+ * while they can preempt the SysTick handler before its clock_tick() call
+ */
+uint64_t clock_get_cycles(void) RAMFUNC;
+
+/**
+ * Get the time elapsed since the clock was started
+ * \return The time in nanoseconds
+ * \note Same restrictions as clock_get_cycles()
+ */
+uint64_t clock_get_ns(void) RAMFUNC;
+
+/**
+ * Get the frequency of the clock
+ * \return The frequency of cycles returned by clock_get_cycles() in Hz
+ */
+unsigned int clock_get_freq(void);
+
+/**
+ * Get a timestamp to measure short intervals: core cycles from the DWT cycle
+ * counter where available, clock_get_cycles() otherwise
+ * \return The timestamp, modulo 2^32
+ * \note Same restrictions as clock_get_cycles()
+ */
+uint32_t clock_get_timestamp(void) RAMFUNC;
+
+/**
+ * Get the frequency of timestamps
+ * \return The frequency of clock_get_timestamp() in Hz
+ */
+unsigned int clock_get_timestamp_freq(void);
+
+#endif
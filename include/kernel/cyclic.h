@@ -0,0 +1,85 @@
+/**
+ * \file cyclic.h
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Time-triggered cyclic executive interface
+ *
+ * A static table, meant to be const so that it stays in flash, lists the
+ * slots of a major frame. Each slot starts at a fixed tick offset in the
+ * frame and runs a function, which must return within the slot length. The
+ * frame repeats forever, driven by SysTick. Slot functions run in an
+ * executive task that preempts every other task and is never preempted by
+ * them, so no scheduling decision is taken for slots. Other tasks run in the
+ * time left between slots. The executive is compiled in with CYCLIC=1.
+ */
+#ifndef H_CYCLIC
+#define H_CYCLIC
+
+#include <kernel/ramfunc.h>
+#include <kernel/stddef.h>
+#include <kernel/stdint.h>
+
+/** Maximum number of slots in a frame */
+#define CYCLIC_MAX_SLOTS (16)
+
+/** Slot of the cyclic schedule */
+typedef struct
+{
+	uint32_t offset;        /**< Start of the slot in the frame, in ticks */
+	uint32_t length;        /**< Length of the slot in ticks */
+	void (*f)(void *);      /**< Slot function */
+	void *arg;              /**< Argument of the slot function */
+} cyclic_slot;
+
+/** Cyclic schedule */
+typedef struct
+{
+	uint32_t frame_length;  /**< Length of the major frame in ticks */
+	const cyclic_slot *slots; /**< Slots, by increasing offset */
+	unsigned int nb_slots;  /**< Number of slots */
+	size_t stack_size;      /**< Stack size of the executive task */
+	/**
+	 * Called from the tick interrupt when a slot function has not returned
+	 * by the end of its slot, may be NULL
+	 * \param[in] slot Index of the slot
+	 */
+	void (*overrun)(unsigned int slot);
+} cyclic_table;
+
+/** Statistics of a slot */
+typedef struct
+{
+	uint32_t runs;          /**< Number of times the slot function ran */
+	uint32_t overruns;      /**< Number of runs longer than the slot */
+	/**
+	 * Number of slot starts dropped because the executive was still busy
+	 * with overrunning slots
+	 */
+	uint32_t skipped;
+	uint32_t max_cycles;    /**< Longest run, in timestamp cycles */
+} cyclic_slot_stats;
+
+/**
+ * Start the cyclic executive. The first frame starts on the next tick.
+ * \param[in] table The cyclic schedule, which must stay valid afterwards
+ * \retval 0 Success
+ * \retval #EINVAL The table is NULL or invalid: slots out of order,
+ * overlapping or out of the frame, or too many slots
+ * \retval #EBUSY The executive is already started
+ * \retval #ENOMEM The executive task cannot be created
+ */
+int cyclic_start(const cyclic_table *table);
+
+/**
+ * Get the statistics of a slot
+ * \param[in] slot Index of the slot
+ * \param[out] stats The slot statistics
+ * \retval 0 Success
+ * \retval #EINVAL stats is NULL, the slot does not exist, or the executive is
+ * not started
+ */
+int cyclic_get_stats(unsigned int slot, cyclic_slot_stats *stats);
+
+/** Start slots and detect overruns, called on every SysTick */
+void cyclic_tick(void) RAMFUNC;
+
+#endif
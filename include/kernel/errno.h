@@ -51,4 +51,7 @@
 /** Operation not permitted */
 #define EPERM (15)
 
+/** Operation timed out */
+#define ETIMEDOUT (16)
+
 #endif
@@ -0,0 +1,108 @@
+/**
+ * \file grant.h
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Zero-copy buffer sharing between tasks
+ */
+#ifndef H_GRANT
+#define H_GRANT
+
+#include <kernel/ramfunc.h>
+#include <kernel/stddef.h>
+#include <kernel/sched.h>
+
+/** Number of buffers in the grant pool (one per MPU subregion) */
+#define GRANT_NB_BUFFERS (8)
+
+/**
+ * Allocate the pool of grantable buffers. Unprivileged tasks may only access
+ * the buffers they currently hold. It must be called by privileged code.
+ *
+ * The other buffer functions are system calls, so that unprivileged tasks can
+ * use them. They must not be called from interrupt handlers.
+ * \param[in] buf_size Size of each buffer in bytes, must be a power of 2 and at
+ * least 32 bytes
+ * \retval 0 Success
+ * \retval #EINVAL Invalid buffer size
+ * \retval #EBUSY Pool already allocated
+ * \retval #ENOMEM Not enough memory for the pool
+ */
+int grant_init(size_t buf_size);
+
+/**
+ * Allocate a buffer owned and held by the calling task
+ * \return A pointer to the buffer, NULL if no buffer is available
+ */
+void * grant_alloc(void);
+
+/**
+ * Lend a buffer to another task. The calling task loses access to the buffer
+ * until it is returned.
+ * \param[in] buf The buffer to lend
+ * \param[in] t The task which receives the buffer
+ * \retval 0 Success
+ * \retval #EINVAL Invalid buffer or task
+ * \retval #EPERM The calling task does not own or does not hold the buffer
+ */
+int grant_lend(void *buf, task_t *t);
+
+/**
+ * Return a borrowed buffer to its owner
+ * \param[in] buf The buffer to return
+ * \retval 0 Success
+ * \retval #EINVAL Invalid buffer
+ * \retval #EPERM The calling task does not hold the buffer
+ */
+int grant_return(void *buf);
+
+/**
+ * Free a buffer
+ * \param[in] buf The buffer to free
+ * \retval 0 Success
+ * \retval #EINVAL Invalid buffer
+ * \retval #EPERM The calling task does not own or does not hold the buffer
+ */
+int grant_free(void *buf);
+
+/**
+ * Kernel side of grant_alloc(), run by the system call handler
+ * \return A pointer to the buffer, NULL if no buffer is available
+ */
+void * grant_do_alloc(void);
+
+/**
+ * Kernel side of grant_lend(), run by the system call handler
+ * \param[in] buf The buffer to lend
+ * \param[in] t The task which receives the buffer
+ * \return See grant_lend()
+ */
+int grant_do_lend(void *buf, task_t *t);
+
+/**
+ * Kernel side of grant_return(), run by the system call handler
+ * \param[in] buf The buffer to return
+ * \return See grant_return()
+ */
+int grant_do_return(void *buf);
+
+/**
+ * Kernel side of grant_free(), run by the system call handler
+ * \param[in] buf The buffer to free
+ * \return See grant_free()
+ */
+int grant_do_free(void *buf);
+
+/**
+ * Give access to the buffers held by a task (called on task switch)
+ * \param[in] t The task that is about to run
+ */
+void grant_switch(const task_t *t) RAMFUNC;
+
+/**
+ * Release the buffers of a terminated task. Buffers it borrowed are returned to
+ * their owners. Buffers it owns and holds are freed, buffers it owns and lent
+ * are given to the task holding them, which becomes their owner.
+ * \param[in] t The terminated task
+ */
+void grant_release_task(const task_t *t);
+
+#endif
@@ -6,6 +6,7 @@
 #ifndef H_HANDLERS
 #define H_HANDLERS
 
+#include <kernel/ramfunc.h>
 #include <kernel/stdint.h>
 
 /** Kernel entry point (reset vector) */
@@ -27,7 +28,7 @@ void handler_busfault(void) __attribute__((naked));
 void handler_usage(void) __attribute__((naked));
 
 /** PendSV handler */
-void handler_pendSV(void) __attribute__((naked));
+void handler_pendSV(void) __attribute__((naked)) RAMFUNC;
 
 /**
  * Supervisor call handler
@@ -38,13 +39,13 @@ void handler_pendSV(void) __attribute__((naked));
  * \param[in] num Number of the called service
  * \return The return value of the system call
  */
-int handler_svc(uint32_t p1, uint32_t p2, uint32_t p3, uint32_t p4,
-                uint32_t num);
+uint32_t handler_svc(uint32_t p1, uint32_t p2, uint32_t p3, uint32_t p4,
+                     uint32_t num);
 
 /** Systick handler */
-void handler_systick(void);
+void handler_systick(void) RAMFUNC;
 
 /** Interrupt handler */
-void handler_interrupt(void);
+void handler_interrupt(void) RAMFUNC;
 
 #endif
@@ -6,6 +6,8 @@
 #ifndef H_IRQ
 #define H_IRQ
 
+#include <kernel/stdint.h>
+
 /**
  * Prototype of IRQ handlers
  * \param data Private data for IRQ handler needs
@@ -32,4 +34,34 @@ int irq_register(int irq, irq_handler handler, void *data);
  */
 int irq_release(int irq);
 
+/** IRQ statistics */
+typedef struct
+{
+	uint32_t count;         /**< Number of times the handler was called */
+	uint64_t total_cycles;  /**< Cycles spent in the handler, including
+	                             interrupts that preempted it */
+	uint32_t max_cycles;    /**< Longest handler execution in cycles */
+	uint32_t max_nesting;   /**< Deepest interrupt nesting level the handler
+	                             ran at, 1 if it never preempted another */
+} irq_stats;
+
+/**
+ * Get the statistics of an IRQ. Cycles are clock_get_timestamp() cycles.
+ * \param[in] irq Number of the IRQ
+ * \param[out] stats The IRQ statistics
+ * \retval 0 Success
+ * \retval #EINVAL Invalid IRQ number or NULL pointer
+ * \retval #ENOTSUP Statistics are not compiled in (IRQ_STATS=1)
+ */
+int irq_get_stats(int irq, irq_stats *stats);
+
+/**
+ * Clear the statistics of an IRQ
+ * \param[in] irq Number of the IRQ
+ * \retval 0 Success
+ * \retval #EINVAL Invalid IRQ number
+ * \retval #ENOTSUP Statistics are not compiled in (IRQ_STATS=1)
+ */
+int irq_reset_stats(int irq);
+
 #endif
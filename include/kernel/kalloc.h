@@ -2,25 +2,66 @@
  * \file kalloc.h
  * \author Maxime Bernelas <maxime@bernelas.fr>
  * Kernel memory allocator interface
+ *
+ * The heap is shared by tasks and the scheduler, which frees terminated tasks
+ * in the context switch handler. The allocator updates it with IRQs masked,
+ * which only privileged code can do: it must be called from privileged tasks
+ * or interrupt handlers. Calls from unprivileged tasks fail.
  */
 #ifndef H_KALLOC
 #define H_KALLOC
 
+#include <kernel/ramfunc.h>
 #include <kernel/stddef.h>
 
+/** Heap usage snapshot */
+typedef struct
+{
+	size_t free_bytes;            /**< Usable bytes in free blocks */
+	size_t largest_free;          /**< Usable bytes in the largest free
+	                                   block */
+	unsigned int nb_blocks;       /**< Number of blocks, free or used */
+	unsigned int nb_free_blocks;  /**< Number of free blocks */
+} kalloc_stats;
+
+/**
+ * Initialize the memory allocator, or reset it, with a new heap
+ * \param[in] start Start of the memory area managed as the heap
+ * \param[in] size Size of the area in bytes
+ * \retval 0 Success
+ * \retval #EINVAL The area is too small to hold a block
+ */
+int kalloc_init(void *start, size_t size);
+
 /**
- * Initialize the memory allocator
+ * Get a snapshot of the heap usage. Fragmentation shows as a largest free
+ * block much smaller than the free bytes in total.
+ * \param[out] stats The heap usage
  * \retval 0 Success
+ * \retval #EINVAL stats is NULL
+ * \retval #EPERM The caller is unprivileged
  */
-int kalloc_init(void);
+int kalloc_get_stats(kalloc_stats *stats);
 
 /**
  * Allocate a block of memory
  * \param[in] n Requested memory block size in bytes
  * \return A pointer to the allocated block or NULL on failure
- * \note This function returns NULL on allocation of a 0 byte block
+ * \note This function returns NULL on allocation of a 0 byte block, or if the
+ * caller is unprivileged
+ */
+void * kmalloc(size_t n) RAMFUNC;
+
+/**
+ * Allocate a block of memory aligned on a given boundary
+ * \param[in] n Requested memory block size in bytes
+ * \param[in] align Requested alignment in bytes, must be a power of 2
+ * \return A pointer to the allocated block or NULL on failure
+ * \note This function returns NULL on allocation of a 0 byte block, or if the
+ * caller is unprivileged
+ * \note The block is freed with kfree()
  */
-void * kmalloc(size_t n);
+void * kmalloc_aligned(size_t n, size_t align);
 
 /**
  * Allocate a block of memory initialized to zero
@@ -33,8 +74,9 @@ void * kcalloc(size_t n);
 /**
  * Free an allocated memory block
  * \param[in] p Pointer to the block to free
- * \note If p is NULL, the function does nothing
+ * \note If p is NULL, or if the caller is unprivileged, the function does
+ * nothing
  */
-void kfree(void *p);
+void kfree(void *p) RAMFUNC;
 
 #endif
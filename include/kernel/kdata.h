@@ -0,0 +1,109 @@
+/**
+ * \file kdata.h
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Kernel data block, readable by unprivileged tasks without a system call
+ */
+#ifndef H_KDATA
+#define H_KDATA
+
+#include <kernel/ramfunc.h>
+#include <kernel/stdint.h>
+#include <kernel/sched.h>
+
+/** Size of the kernel data block (smallest MPU region) */
+#define KDATA_SIZE (32)
+
+/**
+ * Kernel data block. It is only written by the kernel, tasks may read it
+ * directly.
+ */
+typedef struct
+{
+	uint32_t seq;             /**< Sequence number, odd during an update */
+	uint32_t ticks;           /**< Number of SysTick periods since boot */
+	uint32_t tick_freq;       /**< SysTick frequency in Hz */
+	const task_t *current;    /**< Currently running task */
+	uint32_t load;            /**< CPU load over the last window, permille */
+} __attribute__((aligned(KDATA_SIZE))) kdata_t;
+
+/** The kernel data block */
+extern const volatile kdata_t kdata;
+
+/**
+ * Start reading several fields of the kernel data block
+ * \return Sequence number to be passed to kdata_read_retry()
+ */
+static inline uint32_t kdata_read_begin(void)
+{
+	uint32_t seq;
+
+	/* Wait for any update in progress to complete */
+	do
+	{
+		seq = kdata.seq;
+	} while(seq & 1);
+
+	return seq;
+}
+
+/**
+ * Check if fields read since kdata_read_begin() may be inconsistent
+ * \param[in] seq Sequence number returned by kdata_read_begin()
+ * \return True if the fields must be read again, false otherwise
+ */
+static inline int kdata_read_retry(uint32_t seq)
+{
+	return (kdata.seq != seq);
+}
+
+/**
+ * Get the number of SysTick periods elapsed since boot
+ * \return The tick count
+ */
+static inline uint32_t kdata_get_ticks(void)
+{
+	return kdata.ticks;
+}
+
+/**
+ * Get the handler of the calling task
+ * \return The handler of the currently running task
+ */
+static inline const task_t *kdata_get_current_task(void)
+{
+	return kdata.current;
+}
+
+/**
+ * Get the CPU load
+ * \return The share of CPU time not spent idle over the last load window, in
+ * permille
+ */
+static inline uint32_t kdata_get_load(void)
+{
+	return kdata.load;
+}
+
+/**
+ * Initialize the kernel data block and map it read-only for unprivileged tasks
+ * \param[in] tick_freq SysTick frequency in Hz
+ * \retval 0 Success
+ */
+int kdata_init(unsigned int tick_freq);
+
+/** Account for a new SysTick period (called from SysTick handler) */
+void kdata_tick(void) RAMFUNC;
+
+/**
+ * Publish the currently running task (called by the scheduler)
+ * \param[in] t The task that is about to run
+ */
+void kdata_set_current_task(const task_t *t) RAMFUNC;
+
+/**
+ * Publish the CPU load (called by the scheduler)
+ * \param[in] load CPU load over the last window in permille
+ */
+void kdata_set_load(uint32_t load);
+
+#endif
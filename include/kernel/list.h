@@ -2,13 +2,17 @@
  * \file list.h
  * \author Maxime Bernelas <maxime@bernelas.fr>
  * Doubly-linked list interface
+ *
+ * Lists are circular and headed by a sentinel item, which is not part of any
+ * object. An empty list is a sentinel linked to itself, so that no operation
+ * has to handle a NULL link and all of them run in constant time.
  */
 #ifndef H_LIST
 #define H_LIST
 
 #include <kernel/stddef.h>
 
-/** List item */
+/** List item, also used as the sentinel heading a list */
 typedef struct _list_item
 {
 	struct _list_item *prev;   /**< Previous item */
@@ -16,51 +20,96 @@ typedef struct _list_item
 } list_item;
 
 /**
- * Add an element at head of a list
- * \param[in,out] list Pointer to the first item of the list. May be modified by
- * the function in case the list was empty
- * \param[in] item Item to add to the list
- * \retval 0 Success
- * \retval #EINVAL Item is NULL
+ * Static initializer of an empty list
+ * \param[in] name Name of the list_item variable heading the list
  */
-int list_add_head(list_item **list, list_item *item);
+#define LIST_INIT(name) {&(name), &(name)}
 
 /**
- * Add an element at end of a list
- * \param[in,out] list Pointer to the first item of the list. May be modified by
- * the function in case the list was empty
- * \param[in] item Item to add to the list
- * \retval 0 Success
- * \retval #EINVAL Item is NULL
+ * Initialize an empty list, or an item that belongs to no list
+ * \param[out] item The list sentinel or the item
  */
-int list_add_tail(list_item **list, list_item *item);
-
-/**
- * Remove an item of a list
- * \param[in,out] list Pointer to the first item of the list. May be modified by
- * the function in case the item was first in the list
- * \param[in] item Item to add to the list
- * \retval 0 Success
- * \retval #EINVAL Item is NULL or list is empty
- */
-int list_remove(list_item **list, list_item *item);
+static inline void list_init(list_item *item)
+{
+	item->prev = item;
+	item->next = item;
+}
 
 /**
  * Test if a list is empty
- * \param[in] list Pointer to the list
+ * \param[in] list The list sentinel
  * \retval 0 List is not empty
  * \retval 1 List is empty
  */
-int list_is_empty(list_item *list);
+static inline int list_is_empty(const list_item *list)
+{
+	return (list->next == list);
+}
 
 /**
  * Insert a node after another
- * \param[in] a The first node
+ * \param[in] a The first node, may be a list sentinel
  * \param[in] b The new node to insert after a
- * \retval 0 Success
- * \retval #EINVAL Item a or b is NULL
  */
-int list_insert_after(list_item *a, list_item *b);
+static inline void list_insert_after(list_item *a, list_item *b)
+{
+	b->prev = a;
+	b->next = a->next;
+	a->next->prev = b;
+	a->next = b;
+}
+
+/**
+ * Insert a node before another
+ * \param[in] a The first node, may be a list sentinel
+ * \param[in] b The new node to insert before a
+ */
+static inline void list_insert_before(list_item *a, list_item *b)
+{
+	list_insert_after(a->prev, b);
+}
+
+/**
+ * Add an element at head of a list
+ * \param[in] list The list sentinel
+ * \param[in] item Item to add to the list
+ */
+static inline void list_add_head(list_item *list, list_item *item)
+{
+	list_insert_after(list, item);
+}
+
+/**
+ * Add an element at end of a list
+ * \param[in] list The list sentinel
+ * \param[in] item Item to add to the list
+ */
+static inline void list_add_tail(list_item *list, list_item *item)
+{
+	list_insert_before(list, item);
+}
+
+/**
+ * Remove an item from the list it belongs to. The item is then linked to
+ * itself, so removing it again has no effect.
+ * \param[in] item Item to remove
+ */
+static inline void list_remove(list_item *item)
+{
+	item->prev->next = item->next;
+	item->next->prev = item->prev;
+	list_init(item);
+}
+
+/**
+ * Get the first item of a list
+ * \param[in] list The list sentinel
+ * \return The first item, NULL if the list is empty
+ */
+static inline list_item *list_first(const list_item *list)
+{
+	return list_is_empty(list) ? NULL : list->next;
+}
 
 /**
  * Get the object containing a list item
@@ -72,4 +121,36 @@ int list_insert_after(list_item *a, list_item *b);
 #define LIST_GET_OBJECT(p, type, member) \
 	((type *)(((char *)(p)) - (offsetof(type, member))))
 
+/**
+ * Iterate over the items of a list
+ * \param[out] pos list_item pointer set to each item in turn
+ * \param[in] list The list sentinel
+ * \note The current item must not be removed in the loop body, see
+ * #LIST_FOR_EACH_SAFE
+ */
+#define LIST_FOR_EACH(pos, list) \
+	for((pos) = (list)->next; (pos) != (list); (pos) = (pos)->next)
+
+/**
+ * Iterate over the items of a list, allowing removal of the current item
+ * \param[out] pos list_item pointer set to each item in turn
+ * \param[out] tmp list_item pointer used as temporary storage
+ * \param[in] list The list sentinel
+ */
+#define LIST_FOR_EACH_SAFE(pos, tmp, list)                                     \
+	for((pos) = (list)->next, (tmp) = (pos)->next; (pos) != (list);        \
+	    (pos) = (tmp), (tmp) = (pos)->next)
+
+/**
+ * Iterate over the objects of a list
+ * \param[out] obj Object pointer set to each object in turn
+ * \param[in] list The list sentinel
+ * \param[in] type Type of the objects
+ * \param[in] member Member name of the list item in the objects
+ */
+#define LIST_FOR_EACH_OBJECT(obj, list, type, member)                          \
+	for((obj) = LIST_GET_OBJECT((list)->next, type, member);               \
+	    &(obj)->member != (list);                                          \
+	    (obj) = LIST_GET_OBJECT((obj)->member.next, type, member))
+
 #endif
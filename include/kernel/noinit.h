@@ -0,0 +1,16 @@
+/**
+ * \file noinit.h
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Placement of variables that are not initialized at boot
+ */
+#ifndef H_NOINIT
+#define H_NOINIT
+
+/**
+ * Place a variable in the .noinit section. Such variables are neither loaded
+ * nor cleared by kernel_entry(), which shortens boot for large buffers and
+ * lets data survive a reset. Their content is undefined after power-up.
+ */
+#define NOINIT __attribute__((section(".noinit")))
+
+#endif
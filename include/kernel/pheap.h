@@ -0,0 +1,108 @@
+/**
+ * \file pheap.h
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Pairing heap interface
+ *
+ * Intrusive priority queue: items are embedded in the objects they order, as
+ * with lists, so the heap never allocates memory. Peeking at the minimum and
+ * inserting run in O(1), removing runs in amortized O(log n).
+ */
+#ifndef H_PHEAP
+#define H_PHEAP
+
+#include <kernel/ramfunc.h>
+#include <kernel/stddef.h>
+
+/** Pairing heap item */
+typedef struct _pheap_item
+{
+	struct _pheap_item *child;  /**< First child */
+	struct _pheap_item *next;   /**< Next sibling */
+	struct _pheap_item *prev;   /**< Previous sibling, or parent if first */
+} pheap_item;
+
+/**
+ * Item comparison function
+ * \param[in] a First item
+ * \param[in] b Second item
+ * \return True if a must be extracted before b, false otherwise
+ */
+typedef int (*pheap_less)(const pheap_item *a, const pheap_item *b);
+
+/** Pairing heap */
+typedef struct
+{
+	pheap_item *root;   /**< Minimum item, NULL if the heap is empty */
+	pheap_less less;    /**< Item comparison function */
+} pheap;
+
+/**
+ * Static initializer of an empty heap
+ * \param[in] less Item comparison function
+ */
+#define PHEAP_INIT(less) {NULL, (less)}
+
+/**
+ * Initialize an empty heap
+ * \param[out] h The heap
+ * \param[in] less Item comparison function
+ */
+static inline void pheap_init(pheap *h, pheap_less less)
+{
+	h->root = NULL;
+	h->less = less;
+}
+
+/**
+ * Test if a heap is empty
+ * \param[in] h The heap
+ * \retval 0 Heap is not empty
+ * \retval 1 Heap is empty
+ */
+static inline int pheap_is_empty(const pheap *h)
+{
+	return (h->root == NULL);
+}
+
+/**
+ * Get the minimum item of a heap, without removing it
+ * \param[in] h The heap
+ * \return The minimum item, NULL if the heap is empty
+ */
+static inline pheap_item *pheap_peek(const pheap *h)
+{
+	return h->root;
+}
+
+/**
+ * Add an item to a heap
+ * \param[in,out] h The heap
+ * \param[in] item Item to add, must not be in a heap
+ */
+void pheap_insert(pheap *h, pheap_item *item) RAMFUNC;
+
+/**
+ * Remove the minimum item of a heap
+ * \param[in,out] h The heap
+ * \return The removed item, NULL if the heap is empty
+ */
+pheap_item *pheap_pop(pheap *h) RAMFUNC;
+
+/**
+ * Remove any item from a heap
+ * \param[in,out] h The heap
+ * \param[in] item Item to remove, must be in h
+ */
+void pheap_remove(pheap *h, pheap_item *item) RAMFUNC;
+
+/**
+ * Get the object containing a heap item
+ * \param[in] p Pointer to the heap item
+ * \param[in] type Type of the containing object
+ * \param[in] member Member name of the heap item in the containing object
+ * \return A pointer to the object containing the given heap item
+ */
+#define PHEAP_GET_OBJECT(p, type, member) \
+	((type *)(((char *)(p)) - (offsetof(type, member))))
+
+#endif
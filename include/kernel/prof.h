@@ -0,0 +1,73 @@
+/**
+ * \file prof.h
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Statistical profiler interface
+ *
+ * On every SysTick, the PC of the interrupted task is sampled and counted in
+ * a histogram of code address ranges, the prof_data symbol. It is dumped
+ * through the debugger and mapped back to functions on the host with
+ * tools/prof2syms.py. The profiler is compiled in with PROFILE=1.
+ */
+#ifndef H_PROF
+#define H_PROF
+
+#include <kernel/ramfunc.h>
+#include <kernel/stdint.h>
+
+/** Number of histogram buckets for code in flash */
+#define PROF_NB_FLASH_BUCKETS (512)
+
+/** Number of histogram buckets for code in SRAM (.ramfunc) */
+#define PROF_NB_RAM_BUCKETS (64)
+
+/** Total number of histogram buckets */
+#define PROF_NB_BUCKETS (PROF_NB_FLASH_BUCKETS + PROF_NB_RAM_BUCKETS)
+
+/** Number of code address ranges */
+#define PROF_NB_RANGES (2)
+
+/** Profile data magic number ("MPRF") */
+#define PROF_MAGIC (0x4652504DU)
+
+/** Profile data format version */
+#define PROF_VERSION (1)
+
+/** Code address range covered by histogram buckets */
+typedef struct
+{
+	uint32_t start;       /**< First address of the range */
+	uint32_t end;         /**< Address following the range */
+	uint32_t shift;       /**< log2 of the number of bytes per bucket */
+	uint32_t first;       /**< Index of the first bucket of the range */
+	uint32_t nb;          /**< Number of buckets of the range */
+} prof_range;
+
+/** Profile data, as found in memory dumps */
+typedef struct
+{
+	uint32_t magic;       /**< #PROF_MAGIC once the profiler is started */
+	uint32_t version;     /**< #PROF_VERSION */
+	uint32_t samples;     /**< Number of samples taken */
+	uint32_t other;       /**< Samples outside of the code ranges */
+	uint32_t nb_ranges;   /**< Number of code ranges */
+	prof_range ranges[PROF_NB_RANGES]; /**< Code ranges */
+	uint32_t nb_buckets;  /**< Number of buckets */
+	uint16_t buckets[PROF_NB_BUCKETS]; /**< Sample counts, saturated */
+} prof_data_t;
+
+/**
+ * Start the profiler
+ * \retval 0 Success
+ */
+int prof_init(void);
+
+/** Clear all samples */
+void prof_reset(void);
+
+/**
+ * Take a sample, called from the SysTick handler
+ * \param[in] exc_return EXC_RETURN value of the SysTick exception
+ */
+void prof_sample(uint32_t exc_return) RAMFUNC;
+
+#endif
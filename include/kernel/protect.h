@@ -0,0 +1,48 @@
+/**
+ * \file protect.h
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Kernel memory protection policy
+ */
+#ifndef H_PROTECT
+#define H_PROTECT
+
+/*
+ * MPU regions used by the kernel. When regions overlap, the one with the
+ * highest number takes precedence.
+ */
+/** Background region for code memory */
+#define PROTECT_REGION_FLASH (0)
+
+/** Background region for SRAM */
+#define PROTECT_REGION_SRAM (1)
+
+/** Background region for peripherals */
+#define PROTECT_REGION_PERIPH (2)
+
+/** Kernel data block, read-only for tasks */
+#define PROTECT_REGION_KDATA (3)
+
+/** Pool of grantable buffers, opened for the buffers held by the running task */
+#define PROTECT_REGION_GRANT (4)
+
+/** Stack guard of the running task */
+#define PROTECT_REGION_STACK_GUARD (7)
+
+/** Number of MPU regions needed by the kernel */
+#define PROTECT_NB_REGIONS (8)
+
+/**
+ * Setup background regions and enable the MPU. Without regions, unprivileged
+ * tasks keep the same access rights as when the MPU is disabled.
+ * \retval 0 Success
+ * \retval #ENODEV No MPU, or the MPU does not have enough regions
+ */
+int protect_init(void);
+
+/**
+ * Check if memory protection is enabled
+ * \return True if protect_init() succeeded, false otherwise
+ */
+int protect_is_enabled(void);
+
+#endif
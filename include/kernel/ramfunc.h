@@ -0,0 +1,21 @@
+/**
+ * \file ramfunc.h
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Placement of hot code paths in SRAM
+ */
+#ifndef H_RAMFUNC
+#define H_RAMFUNC
+
+#ifdef CONFIG_RAMFUNC
+/**
+ * Place a function in SRAM, where it executes without flash wait states. The
+ * function is copied from flash by kernel_entry(). Calls go through a register
+ * because SRAM is out of reach of a direct branch from flash.
+ */
+#define RAMFUNC __attribute__((section(".ramfunc"), long_call))
+#else
+/** Hot code paths are left in flash */
+#define RAMFUNC
+#endif
+
+#endif
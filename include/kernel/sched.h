@@ -6,27 +6,109 @@
 #ifndef H_SCHED
 #define H_SCHED
 
+#include <kernel/ramfunc.h>
 #include <kernel/stddef.h>
+#include <kernel/stdint.h>
+
+/** Default task quantum in ticks */
+#define SCHED_DEFAULT_QUANTUM (1)
 
 /** Opaque task descriptor type */
 typedef struct _task task_t;
 
+/** Task CPU usage statistics */
+typedef struct
+{
+	uint64_t run_cycles;  /**< Cycles spent running since creation */
+	uint32_t switches;    /**< Number of times the task was switched in */
+	uint32_t load;        /**< CPU share over the last load window, permille */
+} sched_task_stats;
+
+/** Number of buckets of the scheduling latency histogram */
+#define SCHED_LATENCY_NB_BUCKETS (24)
+
+/** Scheduling latency statistics of a task */
+typedef struct
+{
+	uint32_t count;       /**< Number of wakeups dispatched */
+	uint32_t max_cycles;  /**< Longest latency */
+	/**
+	 * Number of wakeups by log2 of their latency, the last bucket also
+	 * holds longer ones. Counts saturate.
+	 */
+	uint16_t histogram[SCHED_LATENCY_NB_BUCKETS];
+} sched_latency_stats;
+
 /**
  * Create a new task
  * \param[in] f Task routine
  * \param[in] arg Task argument
- * \param[in] stack_size Size of task's stack in bytes
+ * \param[in] stack_size Size of task's stack in bytes, see
+ * sched_stack_high_water() to size it. With the MPU, overflows are caught by a
+ * guard region of STACK_GUARD_SIZE bytes (build option) below the stack, as
+ * long as no single stack frame is larger.
  * \param[in] priv True if task must be privileged, false otherwise
+ * \param[in] quantum Number of ticks the task runs before being preempted,
+ * 0 for #SCHED_DEFAULT_QUANTUM. Long quanta suit batch tasks, short ones
+ * interactive tasks.
  * \return The new task handler, NULL on failure
  */
 task_t *sched_create_task(void (*f)(void *), void *arg, size_t stack_size,
-                          unsigned char priv);
+                          unsigned char priv, uint32_t quantum);
 
 /** Put task to sleep waiting for an event */
 void sched_sleep(void);
 
+/**
+ * Put task to sleep for a number of ticks
+ * \param[in] ticks Minimum number of ticks to sleep. The task is woken up on
+ * the (ticks + 1)th tick after the call, so that it sleeps for at least ticks
+ * tick periods wherever the call falls within the current tick.
+ * \param[in] slack Number of ticks the wakeup may be delayed by. Tasks with
+ * overlapping wakeup windows are woken up on the same tick, which saves
+ * context switches and leaves the CPU idle for longer.
+ * \retval 0 Success
+ * \retval #EINVAL ticks is 0, or no task is running
+ */
+int sched_sleep_ticks(uint32_t ticks, uint32_t slack);
+
+/**
+ * Wake up a sleeping task, cancelling its timeout if any. It can be called
+ * from interrupt handlers.
+ * \param[in] t The task handler
+ * \retval 0 Success (including if the task was not sleeping)
+ * \retval #EINVAL t is NULL
+ */
+int sched_wakeup(task_t *t);
+
+/**
+ * Set the priority and preemption threshold of a task. The ready task with
+ * the highest priority runs, tasks of equal priority share the CPU in turn.
+ * A running task is only preempted by tasks with a priority above its
+ * threshold: tasks whose priorities are up to the threshold do not preempt
+ * each other, which saves context switches and stack space. Tasks are created
+ * with priority and threshold 0.
+ * \param[in] t The task handler
+ * \param[in] priority Priority of the task, 0 is the lowest
+ * \param[in] threshold Preemption threshold, at least the priority
+ * \retval 0 Success
+ * \retval #EINVAL t is NULL, or threshold is below priority
+ */
+int sched_set_priority(task_t *t, uint8_t priority, uint8_t threshold);
+
+/**
+ * Move a task to the time-triggered class, ahead of all other tasks. The task
+ * runs as soon as it is ready and keeps the CPU until it sleeps or yields:
+ * neither ticks nor other tasks preempt it. It is meant for the cyclic
+ * executive (see cyclic.h).
+ * \param[in] t The task handler
+ * \retval 0 Success
+ * \retval #EINVAL t is NULL
+ */
+int sched_set_time_triggered(task_t *t);
+
 /** Relinquish processor without putting task to sleep (task becomes ready) */
-void sched_yield(void);
+void sched_yield(void) RAMFUNC;
 
 /**
  * Initialize scheduler (creates idle task)
@@ -34,8 +116,20 @@ void sched_yield(void);
  */
 int sched_init(void);
 
+/**
+ * Wake up tasks whose sleep has expired, and preempt the current task at the
+ * end of its quantum. Called on every SysTick.
+ */
+void sched_tick(void) RAMFUNC;
+
 /** Run scheduler and switch task if necessary */
-void schedule(void);
+void schedule(void) RAMFUNC;
+
+/**
+ * Terminate the current task, run by the system call handler when the task
+ * routine returns. The task is released by the next context switch.
+ */
+void sched_do_exit(void);
 
 /**
  * Check if current task is privileged
@@ -43,4 +137,58 @@ void schedule(void);
  */
 int sched_is_task_privileged(void);
 
+/**
+ * Get the currently running task
+ * \return The handler of the current task, NULL before the first task switch
+ */
+task_t *sched_get_current_task(void);
+
+/**
+ * Get the CPU usage statistics of a task. Cycles are core cycles when the
+ * DWT cycle counter is available, SysTick counter cycles otherwise.
+ * \param[in] t The task handler, NULL for the idle task
+ * \param[out] stats The task statistics
+ * \retval 0 Success
+ * \retval #EINVAL stats is NULL
+ */
+int sched_get_task_stats(task_t *t, sched_task_stats *stats);
+
+/**
+ * Get the scheduling latency statistics of a task: the time between a wakeup,
+ * by sched_wakeup() or at the end of a timed sleep, and the dispatch of the
+ * task by schedule(). Cycles are clock_get_timestamp() cycles.
+ * \param[in] t The task handler
+ * \param[out] stats The latency statistics
+ * \retval 0 Success
+ * \retval #EINVAL t or stats is NULL
+ * \retval #ENOTSUP Statistics are not compiled in (SCHED_LATENCY=1)
+ */
+int sched_get_latency_stats(task_t *t, sched_latency_stats *stats);
+
+/**
+ * Get the CPU load
+ * \return The share of CPU time not spent idle over the last load window, in
+ * permille. The window covers the last 100 ticks and slides every 10 ticks.
+ */
+unsigned int sched_get_cpu_load(void);
+
+/**
+ * Check if an address lies in the stack guard region of a task
+ * \param[in] t The task handler
+ * \param[in] addr The address to check
+ * \return True if addr is in the stack guard of t, false otherwise (or if t
+ * has no stack guard)
+ */
+int sched_is_stack_guard(task_t *t, void *addr);
+
+/**
+ * Get the stack high-water mark of a task. Stacks are painted at creation,
+ * the mark is the distance from the top of the stack to the lowest word that
+ * does not hold the pattern anymore. Ticks that find the CPU idle also refresh
+ * the marks of all tasks, a few words at a time.
+ * \param[in] t The task handler, NULL for the idle task
+ * \return The maximum number of stack bytes used by the task so far
+ */
+size_t sched_stack_high_water(task_t *t);
+
 #endif
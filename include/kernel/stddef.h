@@ -12,13 +12,13 @@
 #define NULL ((void *)0)
 
 /** Unsigned integer type capable of holding the size of an object */
-typedef uint32_t size_t;
+typedef __SIZE_TYPE__ size_t;
 
 /**
  * Signed integer type capable of holding the result of the subtraction of two
  * pointers
  */
-typedef int32_t ptrdiff_t;
+typedef __PTRDIFF_TYPE__ ptrdiff_t;
 
 /**
  * Macro giving the offset in bytes of a structure member relative to the
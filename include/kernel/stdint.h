@@ -27,11 +27,15 @@ typedef int int32_t;
 /** 32-bits unsigned integer */
 typedef unsigned int uint32_t;
 
+/*
+ * 64-bits types are the ones of the compiler (long long on the target, long
+ * on 64-bits hosts), so that host code can mix these headers with its C library
+ */
 /** 64-bits signed integer */
-typedef signed long long int64_t;
+typedef __INT64_TYPE__ int64_t;
 
 /** 64-bits unsigned integer */
-typedef unsigned long long uint64_t;
+typedef __UINT64_TYPE__ uint64_t;
 
 
 /*
@@ -91,13 +95,14 @@ typedef uint64_t uint_fast64_t;
 
 
 /*
- * Types capables of holding pointers
+ * Types capables of holding pointers, sized by the compiler so that hosted
+ * builds with 64 bits pointers get them right
  */
 /** Signed pointer integer type */
-typedef int32_t intptr_t;
+typedef __INTPTR_TYPE__ intptr_t;
 
 /** Unsigned pointer integer type */
-typedef uint32_t uintptr_t;
+typedef __UINTPTR_TYPE__ uintptr_t;
 
 
 /*
@@ -234,13 +239,13 @@ typedef uint64_t uintmax_t;
  * Limits of types holding pointer values
  */
 /** Minimum value of intptr_t */
-#define INTPTR_MIN INT32_MIN
+#define INTPTR_MIN (-INTPTR_MAX - 1)
 
 /** Maximum value of intptr_t */
-#define INTPTR_MAX INT32_MAX
+#define INTPTR_MAX __INTPTR_MAX__
 
 /** Maximum value of uintptr_t */
-#define UINTPTR_MAX UINT32_MAX
+#define UINTPTR_MAX __UINTPTR_MAX__
 
 
 /*
@@ -17,6 +17,14 @@
  */
 void *memcpy(void *dest, const void *src, size_t n);
 
+/**
+ * Copy a memory area, which may overlap the destination area
+ * \param[out] dest Destination pointer
+ * \param[in] src Source pointer
+ * \param[in] n Number of bytes to copy
+ */
+void *memmove(void *dest, const void *src, size_t n);
+
 /**
  * Fill a memory area with a constant byte value
  * \param[out] dest Destination pointer
@@ -25,4 +33,14 @@ void *memcpy(void *dest, const void *src, size_t n);
  */
 void *memset(void *dest, int val, size_t n);
 
+/**
+ * Compare two memory areas
+ * \param[in] s1 First memory area
+ * \param[in] s2 Second memory area
+ * \param[in] n Number of bytes to compare
+ * \return 0 if both areas are identical, otherwise the difference between the
+ * first differing bytes (as unsigned char) of s1 and s2
+ */
+int memcmp(const void *s1, const void *s2, size_t n);
+
 #endif
@@ -0,0 +1,49 @@
+/**
+ * \file syscall.h
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * System calls
+ *
+ * Kernel services that unprivileged tasks need go through a supervisor call,
+ * so that they run privileged, in handler mode.
+ */
+#ifndef H_SYSCALL
+#define H_SYSCALL
+
+#include <kernel/stdint.h>
+
+/** System call numbers */
+typedef enum
+{
+	SYSCALL_GRANT_ALLOC,    /**< grant_alloc() */
+	SYSCALL_GRANT_LEND,     /**< grant_lend() */
+	SYSCALL_GRANT_RETURN,   /**< grant_return() */
+	SYSCALL_GRANT_FREE,     /**< grant_free() */
+	SYSCALL_TASK_EXIT,      /**< Return from a task routine */
+	SYSCALL_NB              /**< Number of system calls */
+} syscall_num;
+
+/**
+ * Perform a system call from a task (SVC wrapper of the CPU layer)
+ * \param[in] p1 First parameter
+ * \param[in] p2 Second parameter
+ * \param[in] p3 Third parameter
+ * \param[in] p4 Fourth parameter
+ * \param[in] num Number of the called service
+ * \return The return value of the system call
+ */
+uintptr_t __do_svc(uintptr_t p1, uintptr_t p2, uintptr_t p3, uintptr_t p4,
+                   uint32_t num);
+
+/**
+ * Run a system call, called by the supervisor call handler
+ * \param[in] p1 First parameter
+ * \param[in] p2 Second parameter
+ * \param[in] p3 Third parameter
+ * \param[in] p4 Fourth parameter
+ * \param[in] num Number of the called service
+ * \return The return value of the system call, #ENOSYS if num is unknown
+ */
+uintptr_t syscall_dispatch(uintptr_t p1, uintptr_t p2, uintptr_t p3,
+                           uintptr_t p4, uint32_t num);
+
+#endif
@@ -0,0 +1,91 @@
+/**
+ * \file trace.h
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Kernel event tracing interface
+ *
+ * Events are timestamped and stored in a ring buffer in RAM, the trace_buffer
+ * symbol, which is dumped through the debugger and decoded on the host with
+ * tools/trace2json.py. Tracing is compiled in with TRACE=1, otherwise trace
+ * points generate no code at all.
+ */
+#ifndef H_TRACE
+#define H_TRACE
+
+#include <kernel/ramfunc.h>
+#include <kernel/stdint.h>
+
+/** Number of events kept in the ring buffer (power of 2) */
+#define TRACE_NB_EVENTS (128)
+
+/** Trace buffer magic number ("MTRC") */
+#define TRACE_MAGIC (0x4352544DU)
+
+/** Trace buffer format version */
+#define TRACE_VERSION (1)
+
+/** Event types */
+typedef enum
+{
+	TRACE_SWITCH = 1,   /**< Task switch (arg0: previous task state,
+	                         arg1: next task) */
+	TRACE_IRQ_ENTER,    /**< IRQ handler entry (arg0: IRQ number) */
+	TRACE_IRQ_EXIT,     /**< IRQ handler exit (arg0: IRQ number) */
+	TRACE_SVC_ENTER,    /**< System call entry (arg0: call number) */
+	TRACE_SVC_EXIT,     /**< System call exit (arg1: return value) */
+	TRACE_ALLOC,        /**< Allocation (arg0: size, arg1: address) */
+	TRACE_FREE          /**< Deallocation (arg1: address) */
+} trace_event_type;
+
+/** Trace event record */
+typedef struct
+{
+	uint32_t seq;         /**< Event number + 1, 0 while being written */
+	uint32_t timestamp;   /**< Cycle count when the event was recorded */
+	uint16_t type;        /**< Event type, see #trace_event_type */
+	uint16_t arg0;        /**< First event argument */
+	uint32_t arg1;        /**< Second event argument */
+} trace_event;
+
+/** Trace buffer, as found in memory dumps */
+typedef struct
+{
+	uint32_t magic;       /**< #TRACE_MAGIC once tracing is started */
+	uint32_t version;     /**< #TRACE_VERSION */
+	uint32_t nb_events;   /**< Number of event records */
+	uint32_t freq;        /**< Timestamp frequency in Hz */
+	uint32_t head;        /**< Number of events recorded since start */
+	trace_event events[TRACE_NB_EVENTS]; /**< Event ring buffer */
+} trace_buffer_t;
+
+#ifdef CONFIG_TRACE
+/**
+ * Record an event
+ * \param[in] type Event type
+ * \param[in] arg0 First event argument
+ * \param[in] arg1 Second event argument
+ */
+#define TRACE(type, arg0, arg1) \
+	trace_record((type), (uint16_t)(arg0), (uint32_t)(uintptr_t)(arg1))
+#else
+/** Tracing is compiled out, arguments are not evaluated */
+#define TRACE(type, arg0, arg1) do { } while(0)
+#endif
+
+/**
+ * Start tracing, must be called once the scheduler and the clock are set up
+ * \retval 0 Success
+ */
+int trace_init(void);
+
+/**
+ * Record an event, use the #TRACE macro instead. It can be called from
+ * interrupt handlers and privileged tasks. Events are dropped until tracing is
+ * started, and when recorded by unprivileged tasks, which cannot read the
+ * timestamp: the core registers it comes from are privileged.
+ * \param[in] type Event type
+ * \param[in] arg0 First event argument
+ * \param[in] arg1 Second event argument
+ */
+void trace_record(trace_event_type type, uint16_t arg0, uint32_t arg1) RAMFUNC;
+
+#endif
@@ -0,0 +1,127 @@
+/**
+ * \file posix_host.h
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Host process services of the hosted port
+ *
+ * The hosted port runs the kernel as a Linux process. Tasks are ucontext
+ * contexts, SysTick is an interval timer signal and PendSV is emulated in
+ * software. This interface only uses plain C types, so that it can be used by
+ * the files of the port built against the kernel headers as well as by the
+ * file built against the host C library.
+ */
+#ifndef H_POSIX_HOST
+#define H_POSIX_HOST
+
+/**
+ * Create a task execution context, running on its own host stack
+ * \param[in] func Task entry point
+ * \param[in] arg Task function parameter
+ * \param[in] stop_func Function to call when task terminates
+ * \return The new context, NULL if host memory is exhausted
+ */
+void *posix_context_create(void (*func)(void *), void *arg,
+                           void (*stop_func)(void));
+
+/**
+ * Switch execution to a context. The context of a task that has terminated is
+ * released once switched away from.
+ * \param[in] ctx The context to run
+ */
+void posix_context_switch(void *ctx);
+
+/**
+ * Mask emulated interrupts
+ * \return The previous mask state, 1 if masked, 0 otherwise
+ */
+int posix_irq_disable(void);
+
+/**
+ * Restore the emulated interrupts mask, running exceptions that became
+ * pending while it was set
+ * \param[in] flags The previous mask state
+ */
+void posix_irq_restore(int flags);
+
+/**
+ * Set the privilege level of thread mode, which takes effect once the running
+ * exception returns
+ * \param[in] priv True for privileged, false for unprivileged
+ */
+void posix_set_privilege(int priv);
+
+/**
+ * Check if the caller runs privileged, in an exception or in privileged
+ * thread mode
+ * \return True if the caller is privileged, false otherwise
+ */
+int posix_is_privileged(void);
+
+/**
+ * Enter the supervisor call exception, from thread mode. The caller runs
+ * privileged, and other exceptions wait until it is over.
+ */
+void posix_svc_enter(void);
+
+/**
+ * Leave the supervisor call exception, running the exceptions that became
+ * pending meanwhile before returning to thread mode
+ */
+void posix_svc_exit(void);
+
+/**
+ * Request a context switch, which runs as soon as interrupts are unmasked and
+ * no other exception is running
+ */
+void posix_pend_switch(void);
+
+/**
+ * Start the periodic timer emulating SysTick
+ * \param[in] period_ns Timer period in nanoseconds
+ * \retval 0 Success
+ * \retval -1 The timer could not be started
+ */
+int posix_timer_start(unsigned long period_ns);
+
+/** Stop the periodic timer */
+void posix_timer_stop(void);
+
+/**
+ * Get the host monotonic time
+ * \return Time in nanoseconds from an arbitrary origin
+ */
+unsigned long long posix_get_time_ns(void);
+
+/** Suspend the process until a signal is received */
+void posix_idle(void);
+
+/**
+ * Write a string to the standard output of the process
+ * \param[in] s The string
+ */
+void posix_print(const char *s);
+
+/**
+ * Terminate the process
+ * \param[in] status Exit status of the process
+ */
+void posix_exit(int status);
+
+/**
+ * Start a new SysTick period, so that the emulated counter value follows the
+ * ticks actually handled
+ */
+void posix_systick_reload(void);
+
+/**
+ * Timer tick handler, the SysTick exception of the hosted port. Called by the
+ * host layer with the timer signal blocked.
+ */
+void posix_handler_tick(void);
+
+/**
+ * Context switch handler, the PendSV exception of the hosted port. Called by
+ * the host layer with the timer signal blocked.
+ */
+void posix_handler_switch(void);
+
+#endif
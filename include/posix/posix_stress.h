@@ -0,0 +1,21 @@
+/**
+ * \file posix_stress.h
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Scheduler and allocator stress workload of the hosted port
+ */
+#ifndef H_POSIX_STRESS
+#define H_POSIX_STRESS
+
+/** Stack size of the stress task in bytes */
+#define POSIX_STRESS_STACK_SIZE (512)
+
+/**
+ * Stress task routine. Creates many short-lived tasks of mixed priorities
+ * and quanta that yield, sleep, allocate or spin, and watches them until
+ * they have all terminated. A summary is printed and the process exits with
+ * status 0 if the run was clean, 1 otherwise.
+ * \param[in] arg Unused
+ */
+void posix_stress_main(void *arg);
+
+#endif
@@ -39,7 +39,7 @@
 #define SOC_TIM3_BASE (CPU_PERIPH_START + 0x400)
 
 /** Timer 4 base address */
-#define SOC_TIM3_BASE (CPU_PERIPH_START + 0x800)
+#define SOC_TIM4_BASE (CPU_PERIPH_START + 0x800)
 
 /** RTC base address */
 #define SOC_RTC_BASE (CPU_PERIPH_START + 0x2800)
@@ -0,0 +1,64 @@
+/**
+ * \file soc_rcc.h
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Reset and clock control interface
+ */
+#ifndef H_SOC_RCC
+#define H_SOC_RCC
+
+/** Frequency of the internal high-speed RC oscillator in Hz */
+#define RCC_HSI_FREQ (8000000U)
+
+/** Maximum SYSCLK frequency in Hz */
+#define RCC_MAX_SYSCLK_FREQ (72000000U)
+
+/** Maximum APB1 clock frequency in Hz */
+#define RCC_MAX_PCLK1_FREQ (36000000U)
+
+/** Maximum ADC clock frequency in Hz */
+#define RCC_MAX_ADCCLK_FREQ (14000000U)
+
+/**
+ * Clock the system from the PLL fed by the external oscillator. Flash wait
+ * states and bus prescalers are adjusted to the resulting frequencies.
+ * \param[in] hse_freq Frequency of the external oscillator in Hz
+ * \param[in] sysclk_freq Requested SYSCLK frequency in Hz, must be a multiple
+ * (2 to 16) of hse_freq and at most #RCC_MAX_SYSCLK_FREQ
+ * \retval 0 Success
+ * \retval #EINVAL The requested frequency cannot be reached
+ * \retval #ETIMEDOUT The external oscillator or the PLL did not start, the
+ * system keeps running from the internal oscillator
+ */
+int rcc_setup(unsigned int hse_freq, unsigned int sysclk_freq);
+
+/**
+ * Get the SYSCLK frequency
+ * \return The SYSCLK frequency in Hz
+ */
+unsigned int rcc_get_sysclk_freq(void);
+
+/**
+ * Get the AHB clock (HCLK) frequency. This is the core and SysTick clock.
+ * \return The HCLK frequency in Hz
+ */
+unsigned int rcc_get_hclk_freq(void);
+
+/**
+ * Get the APB1 peripheral clock frequency
+ * \return The PCLK1 frequency in Hz
+ */
+unsigned int rcc_get_pclk1_freq(void);
+
+/**
+ * Get the APB2 peripheral clock frequency
+ * \return The PCLK2 frequency in Hz
+ */
+unsigned int rcc_get_pclk2_freq(void);
+
+/**
+ * Get the ADC clock frequency
+ * \return The ADCCLK frequency in Hz
+ */
+unsigned int rcc_get_adcclk_freq(void);
+
+#endif
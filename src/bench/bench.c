@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file bench.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Kernel microbenchmarks runner
+ */
+#include <bench/bench.h>
+#include <kernel/clock.h>
+#include <kernel/stddef.h>
+#ifdef CONFIG_SEMIHOSTING
+#include <cpu/cpu_semihost.h>
+#endif
+
+/*******************************************************************************
+ * Private definitions
+ ******************************************************************************/
+volatile int bench_done;
+
+/** Size of the result line buffer, including the terminating null byte */
+#define LINE_SIZE (128)
+
+/** Result line being formatted */
+static char line[LINE_SIZE];
+
+/** Number of characters in #line */
+static size_t line_len;
+
+/**
+ * Append a string to the result line, truncating it if it does not fit
+ * \param[in] s The string to append
+ */
+static void put_str(const char *s)
+{
+	while((*s != '\0') && (line_len < LINE_SIZE - 1))
+		line[line_len++] = *s++;
+	line[line_len] = '\0';
+}
+
+/**
+ * Append an unsigned decimal number to the result line
+ * \param[in] v The number to append
+ */
+static void put_uint(uint32_t v)
+{
+	char digits[11];
+	unsigned int i = sizeof(digits) - 1;
+
+	digits[i] = '\0';
+	do
+	{
+		digits[--i] = '0' + (v % 10);
+		v /= 10;
+	} while(v != 0);
+
+	put_str(&digits[i]);
+}
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+uint32_t bench_get_cycles(void)
+{
+	return clock_get_timestamp();
+}
+
+void bench_report(const char *bench, const char *name, int param,
+                  uint32_t value, const char *unit)
+{
+	line_len = 0;
+	put_str("{\"bench\":\"");
+	put_str(bench);
+	put_str("\",\"case\":\"");
+	put_str(name);
+	put_str("\"");
+	if(param != BENCH_NO_PARAM)
+	{
+		put_str(",\"param\":");
+		put_uint(param);
+	}
+	put_str(",\"value\":");
+	put_uint(value);
+	put_str(",\"unit\":\"");
+	put_str(unit);
+	put_str("\"}\n");
+
+#ifdef CONFIG_SEMIHOSTING
+	semihost_write0(line);
+#endif
+}
+
+void bench_main(void *arg)
+{
+	int status = 0;
+	int ret;
+
+	(void)arg;
+
+	/* Units of every cycle count reported below */
+	bench_report("info", "timestamp_freq", BENCH_NO_PARAM,
+	             clock_get_timestamp_freq(), "Hz");
+
+	ret = bench_string();
+	if(ret != 0)
+		status = ret;
+	ret = bench_sched();
+	if(ret != 0)
+		status = ret;
+	ret = bench_kalloc();
+	if(ret != 0)
+		status = ret;
+	ret = bench_irq();
+	if(ret != 0)
+		status = ret;
+
+	bench_done = 1;
+
+#ifdef CONFIG_SEMIHOSTING
+	semihost_exit(status);
+#else
+	(void)status;
+#endif
+}
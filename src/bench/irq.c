@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014, Maxime Bernelas
+ * Copyright (c) 2015, Maxime Bernelas
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -25,138 +25,84 @@
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 /**
- * \file list.c
+ * \file irq.c
  * \author Maxime Bernelas <maxime@bernelas.fr>
- * Doubly-linked list implementation
+ * Interrupt dispatch benchmark
  */
-#include <kernel/list.h>
-#include <kernel/stddef.h>
+#include <bench/bench.h>
+#include <cpu/cpu_interrupts.h>
+#include <cpu/cpu_nvic.h>
+#include <cpu/cpu_utils.h>
 #include <kernel/errno.h>
+#include <kernel/irq.h>
+#include <kernel/stddef.h>
 
 /*******************************************************************************
- * Private functions
+ * Private definitions
  ******************************************************************************/
 /**
- * Get the last item of a list
- * \param[in] list Poitner to the list
- * \return Pointer to the last item of the list, NULL if list is empty
+ * IRQ triggered by the benchmark. It is only ever pended from software, so
+ * the peripheral behind it does not matter as long as no driver uses it.
  */
-static list_item * last_item(list_item *list)
-{
-	if(list == NULL)
-	{
-		return NULL;
-	}
-
-	while(list->next != NULL)
-	{
-		list = list->next;
-	}
-
-	return list;
-}
-
-/*******************************************************************************
- * Public functions
- ******************************************************************************/
-int list_add_head(list_item **list, list_item *item)
-{
-	if(item == NULL)
-	{
-		return EINVAL;
-	}
-
-	item->prev = NULL;
-	item->next = NULL;
-
-	if(!list_is_empty(*list))
-	{
-		(*list)->prev = item;
-		item->next = *list;
-	}
+#define BENCH_IRQ (CPU_INT_NB_IRQ - 1)
 
-	*list = item;
+/** Number of runs of each measurement, the best one is kept */
+#define NB_RUNS (16)
 
-	return 0;
-}
+/** Timestamp taken by the handler */
+static volatile uint32_t handler_stamp;
 
-int list_add_tail(list_item **list, list_item *item)
+/**
+ * Benchmark IRQ handler, only timestamps its entry
+ * \param[in] data Unused
+ */
+static void handler(void *data)
 {
-	list_item *last;
-
-	if(item == NULL)
-	{
-		return EINVAL;
-	}
+	(void)data;
 
-	item->next = NULL;
-	item->prev = NULL;
-
-	last = last_item(*list);
-
-	if(last == NULL)
-	{
-		/* List is empty */
-		*list = item;
-	}
-	else
-	{
-		last->next = item;
-		item->prev = last;
-	}
-
-	return 0;
+	handler_stamp = bench_get_cycles();
 }
 
-int list_remove(list_item **list, list_item *item)
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+int bench_irq(void)
 {
-	if((item == NULL) || (list == NULL) || list_is_empty(*list))
-	{
-		return EINVAL;
-	}
-
-	if(*list == item)
-	{
-		/* Removing first element */
-		*list = item->next;
-	}
+	uint32_t entry = UINT32_MAX, round_trip = UINT32_MAX;
+	uint32_t start, end;
+	unsigned int i;
 
-	if(item->next != NULL)
-	{
-		item->next->prev = item->prev;
-	}
+	if(irq_register(BENCH_IRQ, handler, NULL) != 0)
+		return EBUSY;
 
-	if(item->prev != NULL)
+	/* Nothing to measure without an interrupt controller */
+	if(nvic_irq_enable(BENCH_IRQ) != 0)
 	{
-		item->prev->next = item->next;
+		irq_release(BENCH_IRQ);
+		return ENOTSUP;
 	}
 
-	item->next = NULL;
-	item->prev = NULL;
-
-	return 0;
-}
-
-int list_is_empty(list_item *list)
-{
-	return (list == NULL);
-}
-
-int list_insert_after(list_item *a, list_item *b)
-{
-	if((a == NULL) || (b == NULL))
+	for(i = 0; i < NB_RUNS; i++)
 	{
-		return EINVAL;
+		start = bench_get_cycles();
+		nvic_irq_set_pending(BENCH_IRQ);
+		/* Make sure the interrupt is taken before reading the time */
+		cpu_dsb();
+		cpu_isb();
+		end = bench_get_cycles();
+
+		if(handler_stamp - start < entry)
+			entry = handler_stamp - start;
+		if(end - start < round_trip)
+			round_trip = end - start;
 	}
 
-	b->next = a->next;
-	b->prev = a;
-	a->next = b;
+	nvic_irq_disable(BENCH_IRQ);
+	irq_release(BENCH_IRQ);
 
-	if((b->next) != NULL)
-	{
-		b->next->prev = b;
-	}
+	bench_report("irq", "dispatch_entry", BENCH_NO_PARAM, entry, "cycles");
+	bench_report("irq", "dispatch_round_trip", BENCH_NO_PARAM, round_trip,
+	             "cycles");
 
 	return 0;
 }
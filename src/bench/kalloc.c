@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file kalloc.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Memory allocator benchmark
+ */
+#include <bench/bench.h>
+#include <kernel/errno.h>
+#include <kernel/kalloc.h>
+
+/*******************************************************************************
+ * Private definitions
+ ******************************************************************************/
+/** Number of blocks allocated to fill the heap */
+#define NB_BLOCKS (32)
+
+/** Size of the blocks filling the heap in bytes */
+#define BLOCK_SIZE (64)
+
+/** Allocation size that fits in the holes left by freed blocks */
+#define SMALL_SIZE (16)
+
+/** Allocation size that does not fit in any hole */
+#define LARGE_SIZE (256)
+
+/** Number of runs of each measurement, the best one is kept */
+#define NB_RUNS (8)
+
+/**
+ * Fragmentation levels, as one freed block every n blocks (0 for none). Freed
+ * blocks are surrounded by used ones, so they cannot merge into larger holes.
+ */
+static const unsigned int hole_strides[] = {0, 4, 2};
+
+/** Number of fragmentation levels */
+#define NB_LEVELS (sizeof(hole_strides) / sizeof(hole_strides[0]))
+
+/** Blocks filling the heap */
+static void *blocks[NB_BLOCKS];
+
+/** Timing of an allocation and the matching release */
+typedef struct
+{
+	uint32_t alloc;   /**< Best number of cycles of kmalloc */
+	uint32_t free;    /**< Best number of cycles of kfree */
+} timing;
+
+/**
+ * Measure the best durations of kmalloc and kfree
+ * \param[in] size Number of bytes to allocate
+ * \param[out] t The lowest numbers of cycles measured over #NB_RUNS runs
+ * \retval 0 Success
+ * \retval #ENOMEM The allocation failed
+ */
+static int measure(size_t size, timing *t)
+{
+	uint32_t start, mid, end;
+	unsigned int i;
+	void *p;
+
+	t->alloc = UINT32_MAX;
+	t->free = UINT32_MAX;
+
+	for(i = 0; i < NB_RUNS; i++)
+	{
+		start = bench_get_cycles();
+		p = kmalloc(size);
+		mid = bench_get_cycles();
+		kfree(p);
+		end = bench_get_cycles();
+
+		if(p == NULL)
+			return ENOMEM;
+
+		if(mid - start < t->alloc)
+			t->alloc = mid - start;
+		if(end - mid < t->free)
+			t->free = end - mid;
+	}
+
+	return 0;
+}
+
+/**
+ * Release all blocks filling the heap
+ */
+static void release_blocks(void)
+{
+	unsigned int i;
+
+	for(i = 0; i < NB_BLOCKS; i++)
+	{
+		kfree(blocks[i]);
+		blocks[i] = NULL;
+	}
+}
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+int bench_kalloc(void)
+{
+	timing small[NB_LEVELS], large[NB_LEVELS];
+	unsigned int level, stride, i;
+	int ret = 0;
+
+	for(level = 0; (level < NB_LEVELS) && (ret == 0); level++)
+	{
+		for(i = 0; i < NB_BLOCKS; i++)
+		{
+			blocks[i] = kmalloc(BLOCK_SIZE);
+			if(blocks[i] == NULL)
+				ret = ENOMEM;
+		}
+
+		stride = hole_strides[level];
+		for(i = 0; (stride != 0) && (i < NB_BLOCKS); i += stride)
+		{
+			kfree(blocks[i]);
+			blocks[i] = NULL;
+		}
+
+		if(ret == 0)
+			ret = measure(SMALL_SIZE, &small[level]);
+		if(ret == 0)
+			ret = measure(LARGE_SIZE, &large[level]);
+
+		release_blocks();
+	}
+
+	if(ret != 0)
+		return ret;
+
+	for(level = 0; level < NB_LEVELS; level++)
+	{
+		/* Percentage of the blocks turned into holes */
+		stride = hole_strides[level];
+		i = (stride == 0) ? 0 : (100 / stride);
+
+		bench_report("kalloc", "kmalloc_small", i, small[level].alloc,
+		             "cycles");
+		bench_report("kalloc", "kfree_small", i, small[level].free,
+		             "cycles");
+		bench_report("kalloc", "kmalloc_large", i, large[level].alloc,
+		             "cycles");
+		bench_report("kalloc", "kfree_large", i, large[level].free,
+		             "cycles");
+	}
+
+	return 0;
+}
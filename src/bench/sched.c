@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file sched.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Scheduler benchmark
+ */
+#include <bench/bench.h>
+#include <kernel/errno.h>
+#include <kernel/sched.h>
+
+/*******************************************************************************
+ * Private definitions
+ ******************************************************************************/
+/** Stack size of the partner task in bytes */
+#define PARTNER_STACK_SIZE (256)
+
+/** Number of runs of each measurement, the best one is kept */
+#define NB_RUNS (8)
+
+/** Number of yields timed by each run */
+#define NB_YIELDS (16)
+
+/** Set to stop the partner task */
+static volatile int partner_stop;
+
+/**
+ * Partner task routine, gives the CPU back to the benchmark task until it is
+ * asked to stop
+ * \param[in] arg Unused
+ */
+static void partner(void *arg)
+{
+	(void)arg;
+
+	while(!partner_stop)
+		sched_yield();
+}
+
+/**
+ * Measure the best duration of a series of yields
+ * \return The lowest number of cycles per yield measured over #NB_RUNS runs
+ */
+static uint32_t measure_yields(void)
+{
+	uint32_t best = UINT32_MAX;
+	uint32_t start, cycles;
+	unsigned int i, j;
+
+	for(i = 0; i < NB_RUNS; i++)
+	{
+		start = bench_get_cycles();
+		for(j = 0; j < NB_YIELDS; j++)
+			sched_yield();
+		cycles = (bench_get_cycles() - start) / NB_YIELDS;
+
+		if(cycles < best)
+			best = cycles;
+	}
+
+	return best;
+}
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+int bench_sched(void)
+{
+	uint32_t self, round_trip;
+
+	/* Alone, a yield goes through the scheduler but switches to itself */
+	self = measure_yields();
+
+	/* With a partner, each yield is a round trip of two context switches */
+	partner_stop = 0;
+	if(sched_create_task(partner, NULL, PARTNER_STACK_SIZE, 1, 0) == NULL)
+		return ENOMEM;
+	round_trip = measure_yields();
+
+	/* Let the partner see the flag and exit */
+	partner_stop = 1;
+	sched_yield();
+
+	bench_report("sched", "yield_self", BENCH_NO_PARAM, self, "cycles");
+	bench_report("sched", "yield_round_trip", BENCH_NO_PARAM, round_trip,
+	             "cycles");
+	bench_report("sched", "context_switch", BENCH_NO_PARAM, round_trip / 2,
+	             "cycles");
+
+	return 0;
+}
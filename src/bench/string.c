@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file string.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Memory block operations benchmark
+ */
+#include <bench/bench.h>
+#include <kernel/errno.h>
+#include <kernel/kalloc.h>
+#include <kernel/string.h>
+
+/*******************************************************************************
+ * Private definitions
+ ******************************************************************************/
+/** Benchmarked size classes in bytes */
+static const unsigned int sizes[] = {4, 16, 64, 256, 1024};
+
+/** Number of size classes */
+#define NB_SIZES (sizeof(sizes) / sizeof(sizes[0]))
+
+/** Largest size class in bytes */
+#define MAX_SIZE (1024)
+
+/** Extra bytes in buffers to apply misalignment and overlap */
+#define BUF_SLACK (16)
+
+/** Offset of the destination for memmove, makes areas overlap */
+#define MOVE_OFFSET (4)
+
+/** Number of runs of each measurement, the best one is kept */
+#define NB_RUNS (8)
+
+/**
+ * Number of calls timed by each run, so that coarse timestamp counters (e.g.
+ * SysTick under emulation) still resolve the shortest calls
+ */
+#define NB_CALLS (8)
+
+/** Benchmarked operation */
+typedef struct
+{
+	const char *name;                            /**< Function name */
+	const char *unaligned_name;                  /**< Misaligned name */
+	void (*run)(unsigned char *a, unsigned char *b,
+	            size_t n);                       /**< Benchmark body */
+} operation;
+
+/** Benchmark body for memcpy */
+static void run_memcpy(unsigned char *a, unsigned char *b, size_t n)
+{
+	memcpy(a, b, n);
+}
+
+/** Benchmark body for memmove, with overlapping areas copied backward */
+static void run_memmove(unsigned char *a, unsigned char *b, size_t n)
+{
+	(void)a;
+	memmove(b + MOVE_OFFSET, b, n);
+}
+
+/** Benchmark body for memset */
+static void run_memset(unsigned char *a, unsigned char *b, size_t n)
+{
+	(void)a;
+	memset(b, 0x5A, n);
+}
+
+/** Sink for memcmp results, keeps calls from being optimized out */
+static volatile int cmp_result;
+
+/** Benchmark body for memcmp, on equal areas to compare every byte */
+static void run_memcmp(unsigned char *a, unsigned char *b, size_t n)
+{
+	cmp_result = memcmp(a, b, n);
+}
+
+/** Empty benchmark body, measures the calling overhead */
+static void run_none(unsigned char *a, unsigned char *b, size_t n)
+{
+	(void)a;
+	(void)b;
+	(void)n;
+}
+
+/** Benchmarked operations */
+static const operation operations[] = {
+	{"memcpy", "memcpy_unaligned", run_memcpy},
+	{"memmove", "memmove_unaligned", run_memmove},
+	{"memset", "memset_unaligned", run_memset},
+	{"memcmp", "memcmp_unaligned", run_memcmp},
+};
+
+/** Number of benchmarked operations */
+#define NB_OPERATIONS (sizeof(operations) / sizeof(operations[0]))
+
+/** Number of source misalignments benchmarked (0 and 1 byte) */
+#define NB_MISALIGNS (2)
+
+bench_string_result bench_string_results[NB_OPERATIONS * NB_SIZES *
+                                         NB_MISALIGNS];
+
+const unsigned int bench_string_nb_results = NB_OPERATIONS * NB_SIZES *
+                                             NB_MISALIGNS;
+
+/**
+ * Measure the best duration of a benchmark body
+ * \param[in] run Benchmark body
+ * \param[in] a First buffer
+ * \param[in] b Second buffer
+ * \param[in] n Number of bytes to process
+ * \return The lowest number of cycles per call measured over #NB_RUNS runs
+ */
+static uint32_t measure(void (*run)(unsigned char *, unsigned char *, size_t),
+                        unsigned char *a, unsigned char *b, size_t n)
+{
+	uint32_t best = UINT32_MAX;
+	uint32_t start, cycles;
+	unsigned int i, j;
+
+	for(i = 0; i < NB_RUNS; i++)
+	{
+		start = bench_get_cycles();
+		for(j = 0; j < NB_CALLS; j++)
+			run(a, b, n);
+		cycles = (bench_get_cycles() - start) / NB_CALLS;
+
+		if(cycles < best)
+			best = cycles;
+	}
+
+	return best;
+}
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+int bench_string(void)
+{
+	bench_string_result *r = bench_string_results;
+	unsigned char *a, *b;
+	unsigned int op, size, mis;
+	uint32_t overhead, cycles;
+
+	a = kmalloc(MAX_SIZE + BUF_SLACK);
+	b = kmalloc(MAX_SIZE + BUF_SLACK);
+	if((a == NULL) || (b == NULL))
+	{
+		kfree(a);
+		kfree(b);
+		return ENOMEM;
+	}
+
+	overhead = measure(run_none, a, b, 0);
+
+	for(op = 0; op < NB_OPERATIONS; op++)
+	{
+		/* Equal buffers so that memcmp reads everything */
+		memset(a, 0x00, MAX_SIZE + BUF_SLACK);
+		memset(b, 0x00, MAX_SIZE + BUF_SLACK);
+
+		for(size = 0; size < NB_SIZES; size++)
+		{
+			for(mis = 0; mis < NB_MISALIGNS; mis++)
+			{
+				cycles = measure(operations[op].run, a,
+				                 b + mis, sizes[size]);
+				cycles = (cycles > overhead) ?
+				         (cycles - overhead) : 1;
+
+				r->name = (mis == 0) ?
+				          operations[op].name :
+				          operations[op].unaligned_name;
+				r->size = sizes[size];
+				r->misalign = mis;
+				r->cycles = cycles;
+				r->bytes_per_kcycle = (sizes[size] * 1000) /
+				                      cycles;
+				r++;
+			}
+		}
+	}
+
+	kfree(a);
+	kfree(b);
+
+	/* Report once done, the output would disturb measurements */
+	for(r = bench_string_results;
+	    r < bench_string_results + bench_string_nb_results; r++)
+	{
+		bench_report("string", r->name, r->size, r->cycles, "cycles");
+		bench_report("string", r->name, r->size, r->bytes_per_kcycle,
+		             "bytes/kcycle");
+	}
+
+	return 0;
+}
@@ -4,4 +4,10 @@ ROOT_DIR := $(shell dirname $(lastword $(MAKEFILE_LIST)))
 # List of object files to build in this directory
 OBJ += $(ROOT_DIR)/vectors.o $(ROOT_DIR)/svc.o $(ROOT_DIR)/utils.o             \
        $(ROOT_DIR)/nvic.o $(ROOT_DIR)/scb.o $(ROOT_DIR)/systick.o              \
-       $(ROOT_DIR)/task.o
+       $(ROOT_DIR)/task.o $(ROOT_DIR)/mpu.o $(ROOT_DIR)/string.o               \
+       $(ROOT_DIR)/dwt.o
+
+# Semihosting, only works under a debugger or an emulator
+ifeq ($(SEMIHOSTING), 1)
+OBJ += $(ROOT_DIR)/semihost.o
+endif
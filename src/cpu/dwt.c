@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file dwt.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Data watchpoint and trace unit driver implementation (cycle counter)
+ */
+#include <kernel/errno.h>
+#include <kernel/stdint.h>
+#include <cpu/cpu_mapping.h>
+
+/*******************************************************************************
+ * Private definitions
+ ******************************************************************************/
+/** DWT register map (only the registers used by this driver) */
+typedef struct
+{
+	uint32_t ctrl;      /**< Control register */
+	uint32_t cyccnt;    /**< Cycle count register */
+} dwt_regs;
+
+/** Cycle counter enable flag */
+#define DWT_CTRL_CYCCNTENA (1U)
+
+/** Cycle counter not implemented flag */
+#define DWT_CTRL_NOCYCCNT (1U << 25)
+
+/** Global enable of the DWT and ITM units in DEMCR */
+#define DEMCR_TRCENA (1U << 24)
+
+/** Pointer used to access the DWT */
+static volatile dwt_regs *dwt = (volatile dwt_regs *)CPU_DWT_BASE;
+
+/** True once the cycle counter is running */
+static int cyccnt_enabled;
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+int dwt_cyccnt_enable(void)
+{
+	/* Do not restart the counter under the feet of its other users */
+	if(cyccnt_enabled)
+		return 0;
+
+#ifdef CONFIG_QEMU
+	/* The emulator does not model the DWT, accessing it would fault */
+	return ENOTSUP;
+#endif
+
+	/* DWT registers are not accessible until trace is enabled */
+	*CPU_DEMCR_REG |= DEMCR_TRCENA;
+
+	if(dwt->ctrl & DWT_CTRL_NOCYCCNT)
+		return ENOTSUP;
+
+	dwt->cyccnt = 0;
+	dwt->ctrl |= DWT_CTRL_CYCCNTENA;
+	cyccnt_enabled = 1;
+
+	return 0;
+}
+
+int dwt_cyccnt_is_enabled(void)
+{
+	return cyccnt_enabled;
+}
+
+uint32_t dwt_get_cyccnt(void)
+{
+	return dwt->cyccnt;
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file mpu.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Memory protection unit management
+ */
+#include <kernel/errno.h>
+#include <kernel/stdint.h>
+#include <cpu/cpu_mapping.h>
+#include <cpu/cpu_mpu.h>
+#include <cpu/cpu_utils.h>
+
+/*******************************************************************************
+ * Private definitions
+ ******************************************************************************/
+/** MPU register map */
+typedef struct
+{
+	uint32_t type;      /**< Type register */
+	uint32_t ctrl;      /**< Control register */
+	uint32_t rnr;       /**< Region number register */
+	uint32_t rbar;      /**< Region base address register */
+	uint32_t rasr;      /**< Region attribute and size register */
+} mpu_regs;
+
+/** MPU enable bit */
+#define MPU_CTRL_ENABLE (1U)
+
+/** Use default memory map as background region for privileged accesses */
+#define MPU_CTRL_PRIVDEFENA (1U << 2)
+
+/** Region number valid bit (RBAR) */
+#define MPU_RBAR_VALID (1U << 4)
+
+/** Region enable bit (RASR) */
+#define MPU_RASR_ENABLE (1U)
+
+/** Position of the size field (RASR) */
+#define MPU_RASR_SIZE_SHIFT (1)
+
+/** Pointer used to access the MPU */
+static volatile mpu_regs *mpu = (volatile mpu_regs *)CPU_MPU_BASE;
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+int mpu_get_nb_regions(void)
+{
+	return ((mpu->type >> 8) & 0xFF);
+}
+
+int mpu_region_compute(int region, void *base, size_t size, uint32_t attr,
+                       mpu_region_t *r)
+{
+	uint32_t addr;
+
+	addr = (uint32_t)base;
+
+	if((region < 0) || (region >= mpu_get_nb_regions()))
+	{
+		return EINVAL;
+	}
+
+	/* Size must be a power of 2 and base address must be aligned on size */
+	if((size < MPU_MIN_REGION_SIZE) || (size & (size - 1)) ||
+	   (addr & (size - 1)))
+	{
+		return EINVAL;
+	}
+
+	r->rbar = addr | MPU_RBAR_VALID | region;
+	r->rasr = attr | ((__builtin_ctz(size) - 1) << MPU_RASR_SIZE_SHIFT) |
+	          MPU_RASR_ENABLE;
+
+	return 0;
+}
+
+void mpu_region_load(const mpu_region_t *r)
+{
+	/* Writing RBAR with the valid bit set also selects the region */
+	mpu->rbar = r->rbar;
+	mpu->rasr = r->rasr;
+}
+
+int mpu_region_setup(int region, void *base, size_t size, uint32_t attr)
+{
+	mpu_region_t r;
+	int ret;
+
+	ret = mpu_region_compute(region, base, size, attr, &r);
+	if(ret != 0)
+	{
+		return ret;
+	}
+
+	mpu_region_load(&r);
+	cpu_dsb();
+	cpu_isb();
+
+	return 0;
+}
+
+int mpu_region_disable(int region)
+{
+	if((region < 0) || (region >= mpu_get_nb_regions()))
+	{
+		return EINVAL;
+	}
+
+	mpu->rnr = region;
+	mpu->rasr = 0;
+	cpu_dsb();
+	cpu_isb();
+
+	return 0;
+}
+
+int mpu_enable(void)
+{
+	if(mpu_get_nb_regions() == 0)
+	{
+		return ENODEV;
+	}
+
+	mpu->ctrl = MPU_CTRL_PRIVDEFENA | MPU_CTRL_ENABLE;
+	cpu_dsb();
+	cpu_isb();
+
+	return 0;
+}
+
+int mpu_disable(void)
+{
+	cpu_dmb();
+	mpu->ctrl = 0;
+
+	return 0;
+}
+
+int mpu_is_enabled(void)
+{
+	return ((mpu->ctrl & MPU_CTRL_ENABLE) != 0);
+}
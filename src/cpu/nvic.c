@@ -85,6 +85,18 @@ int nvic_irq_clear(int irq)
 		return EINVAL;
 	}
 
+	regs->icpr[irq / 32] = (1U << (irq % 32));
+
+	return 0;
+}
+
+int nvic_irq_set_pending(int irq)
+{
+	if((irq < 0) || (irq > CPU_INT_NB_IRQ - 1))
+	{
+		return EINVAL;
+	}
+
 	regs->ispr[irq / 32] = (1U << (irq % 32));
 
 	return 0;
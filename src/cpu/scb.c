@@ -64,6 +64,9 @@ typedef struct
 /** Clear Systick interrupt bit */
 #define SCB_PENDSTCLR (1U << 25)
 
+/** SysTick pending bit in ICSR */
+#define SCB_PENDSTSET (1U << 26)
+
 /** Reset request bit */
 #define SCB_SYSRESETREQ (1U << 2)
 
@@ -73,6 +76,9 @@ typedef struct
 /** Trap on division by 0 bit */
 #define SCB_DIV_0_TRP (1U << 4)
 
+/** Memory management fault exception enable bit */
+#define SCB_MEMFAULTENA (1U << 16)
+
 /** Instruction access violation bit */
 #define SCB_IACCVIOL (1U)
 
@@ -155,6 +161,11 @@ int scb_clear_systick(void)
 	return 0;
 }
 
+int scb_is_systick_pending(void)
+{
+	return ((scb->icsr & SCB_PENDSTSET) != 0);
+}
+
 int scb_request_reset(void)
 {
 	scb->aircr |= SCB_SYSRESETREQ;
@@ -190,6 +201,20 @@ int scb_set_trap_on_div_by_zero(int status)
 	return 0;
 }
 
+int scb_set_mem_manage_fault(int status)
+{
+	if(status)
+	{
+		scb->shcsr |= SCB_MEMFAULTENA;
+	}
+	else
+	{
+		scb->shcsr &= ~(SCB_MEMFAULTENA);
+	}
+
+	return 0;
+}
+
 int scb_get_usage_fault_information(void *stacked_pc, fault_info_t *info)
 {
 	info->cause = FAULT_CAUSE_UNKKNOW;
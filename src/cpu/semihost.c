@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file semihost.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * ARM semihosting implementation
+ */
+#include <cpu/cpu_semihost.h>
+#include <kernel/stdint.h>
+
+/*******************************************************************************
+ * Private definitions
+ ******************************************************************************/
+/** SYS_WRITE0 operation, writes a null-terminated string */
+#define SEMIHOST_SYS_WRITE0 (0x04)
+
+/** SYS_EXIT operation, reports an exception to the host */
+#define SEMIHOST_SYS_EXIT (0x18)
+
+/** Exception reported by SYS_EXIT when the application exits normally */
+#define SEMIHOST_APPLICATION_EXIT (0x20026)
+
+/** Exception reported by SYS_EXIT when the application fails */
+#define SEMIHOST_RUNTIME_ERROR (0x20023)
+
+/**
+ * Issue a semihosting call
+ * \param[in] op Operation number
+ * \param[in] arg Operation argument, usually a pointer to a parameter block
+ * \return The value returned by the host
+ */
+static int semihost_call(int op, const void *arg)
+{
+	register int r0 asm("r0") = op;
+	register const void *r1 asm("r1") = arg;
+
+	asm volatile(
+		"bkpt 0xAB \n\t"
+		: "+r" (r0)
+		: "r" (r1)
+		: "memory");
+
+	return r0;
+}
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+void semihost_write0(const char *s)
+{
+	semihost_call(SEMIHOST_SYS_WRITE0, s);
+}
+
+void semihost_exit(int status)
+{
+	uint32_t reason;
+
+	/*
+	 * The exit status itself needs SYS_EXIT_EXTENDED, which older hosts do
+	 * not know, so only success or failure is reported
+	 */
+	reason = (status == 0) ? SEMIHOST_APPLICATION_EXIT :
+	                         SEMIHOST_RUNTIME_ERROR;
+	semihost_call(SEMIHOST_SYS_EXIT, (const void *)reason);
+
+	while(1)
+		;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2014, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file string.s
+ * This file contains memory block operations moving 8 registers at once
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ */
+.section .text
+.cpu cortex-m3
+.thumb
+.syntax unified
+
+/* Forward burst copy : r0 = dest, r1 = src, r2 = size */
+.global cpu_copy_burst
+.thumb_func
+cpu_copy_burst:
+	push	{ r4-r10 }
+	b	2f
+1:
+	ldmia	r1!, { r3-r10 }
+	stmia	r0!, { r3-r10 }
+2:
+	subs	r2, #32                @ carry is cleared once size goes below 0
+	bhs	1b
+
+	pop	{ r4-r10 }
+	bx	lr
+
+/* Backward burst copy : r0 = dest end, r1 = src end, r2 = size */
+.global cpu_copy_burst_backward
+.thumb_func
+cpu_copy_burst_backward:
+	push	{ r4-r10 }
+	b	2f
+1:
+	ldmdb	r1!, { r3-r10 }
+	stmdb	r0!, { r3-r10 }
+2:
+	subs	r2, #32
+	bhs	1b
+
+	pop	{ r4-r10 }
+	bx	lr
+
+/* Burst fill : r0 = dest, r1 = word, r2 = size */
+.global cpu_fill_burst
+.thumb_func
+cpu_fill_burst:
+	push	{ r4-r9 }
+	mov	r3, r1
+	mov	r4, r1
+	mov	r5, r1
+	mov	r6, r1
+	mov	r7, r1
+	mov	r8, r1
+	mov	r9, r1
+	b	2f
+1:
+	stmia	r0!, { r1, r3-r9 }
+2:
+	subs	r2, #32
+	bhs	1b
+
+	pop	{ r4-r9 }
+	bx	lr
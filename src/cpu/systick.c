@@ -32,6 +32,7 @@
 #include <kernel/errno.h>
 #include <kernel/stdint.h>
 #include <cpu/cpu_mapping.h>
+#include <cpu/cpu_systick.h>
 
 /*******************************************************************************
  * Private definitions
@@ -61,11 +62,18 @@ typedef struct
 #define SYSTICK_IRQ_ENABLE (1U << 1)
 
 /** Pointer used to acces the SysTick */
-static volatile systick_regs *systick = (volatile systick_regs *)CPU_SYSTMR_BASE;
+static volatile systick_regs * const systick =
+	(volatile systick_regs *)CPU_SYSTMR_BASE;
 
 /** Configured SysTick frequency */
 static unsigned int systick_freq;
 
+/** Frequency of the SysTick counter clock */
+static unsigned int systick_clk_freq;
+
+/** Number of counter clock cycles per SysTick period */
+static uint32_t systick_period;
+
 /*******************************************************************************
  * Public functions
  ******************************************************************************/
@@ -77,6 +85,7 @@ int systick_setup(unsigned int freq, unsigned int ahb_freq)
 	systick->ctrl = SYSTICK_CLKSRC_AHB;
 	load = ahb_freq / freq;
 	systick_freq = ahb_freq / load;
+	systick_clk_freq = ahb_freq;
 
 	if(load > SYSTICK_MAX_PERIOD_AHB)
 	{
@@ -84,15 +93,31 @@ int systick_setup(unsigned int freq, unsigned int ahb_freq)
 		systick->ctrl = SYSTICK_CLKSRC_AHB_DIV_8;
 		load = load / 8;
 		systick_freq = (ahb_freq / 8) / load;
+		systick_clk_freq = ahb_freq / 8;
 	}
 
 	if(load < 2)
 	{
 		systick_freq = 0;
+		systick_clk_freq = 0;
+		systick_period = 0;
 		return EINVAL;
 	}
 
+	systick_period = load;
+
 	systick->load = load - 1;
+	/* Start the first period from the reload value */
+	systick->val = 0;
+
+	return 0;
+}
+
+int systick_start_counter(void)
+{
+	systick->load = SYSTICK_VAL_MASK;
+	systick->val = 0;
+	systick->ctrl = SYSTICK_CLKSRC_AHB | SYSTICK_ENABLE;
 
 	return 0;
 }
@@ -117,3 +142,18 @@ unsigned int systick_get_freq(void)
 {
 	return systick_freq;
 }
+
+unsigned int systick_get_clock_freq(void)
+{
+	return systick_clk_freq;
+}
+
+uint32_t systick_get_period(void)
+{
+	return systick_period;
+}
+
+uint32_t systick_get_val(void)
+{
+	return systick->val;
+}
@@ -29,7 +29,10 @@
  * \author Maxime Bernelas <maxime@bernelas.fr>
  * Low-level CPU-related primitives
  */
+#include <cpu/cpu_dwt.h>
 #include <cpu/cpu_utils.h>
+#include <kernel/errno.h>
+#include <kernel/stddef.h>
 
 /*******************************************************************************
  * Private definitions
@@ -45,6 +48,10 @@ enum
 /** Unprivileged thread mode bit */
 #define CPU_CTRL_REG_UNPRIV_BIT (1UL)
 
+/* PSR register fields */
+/** Number of the running exception, 0 in thread mode */
+#define CPU_PSR_EXCEPTION_MASK (0x1FFUL)
+
 /**
  * Set the value of the IRQ enable flag
  * \param[in] flags New value of the flag
@@ -64,6 +71,61 @@ static int cpu_irq_set(int flags)
 	return backup;
 }
 
+#ifdef CONFIG_IRQOFF_STATS
+/** Statistics of the sections run with IRQs disabled */
+static cpu_irqoff_stats irqoff_stats;
+
+/** True once recording is started */
+static int irqoff_recording;
+
+/** True while a recorded section is in progress */
+static int irqoff_active;
+
+/** Timestamp of the beginning of the current section */
+static uint32_t irqoff_start;
+
+/** Caller of cpu_irq_disable() for the current section */
+static void *irqoff_site;
+
+/**
+ * Start recording a section, called with IRQs just disabled
+ * \param[in] site Caller of cpu_irq_disable()
+ */
+static void irqoff_begin(void *site)
+{
+	if(!irqoff_recording)
+		return;
+
+	irqoff_active = 1;
+	irqoff_site = site;
+	irqoff_start = dwt_get_cyccnt();
+}
+
+/** Stop recording a section, called right before IRQs are enabled again */
+static void irqoff_end(void)
+{
+	uint32_t cycles;
+	unsigned int bucket;
+
+	if(!irqoff_active)
+		return;
+
+	cycles = dwt_get_cyccnt() - irqoff_start;
+	irqoff_active = 0;
+
+	irqoff_stats.count++;
+	if(cycles > irqoff_stats.max_cycles)
+	{
+		irqoff_stats.max_cycles = cycles;
+		irqoff_stats.max_site = irqoff_site;
+	}
+
+	/* Bucket n holds durations in [2^n, 2^(n+1)), and 0 in bucket 0 */
+	bucket = (cycles == 0) ? 0 : (31 - __builtin_clz(cycles));
+	irqoff_stats.histogram[bucket]++;
+}
+#endif
+
 /**
  * Get CONTROL register value
  * \return Value of the CONTROL register
@@ -101,17 +163,86 @@ static void set_ctrl_reg(uint32_t val)
  ******************************************************************************/
 void cpu_irq_restore(int flags)
 {
+#ifdef CONFIG_IRQOFF_STATS
+	if(flags == CPU_IRQ_ENABLED)
+		irqoff_end();
+#endif
+
 	cpu_irq_set(flags);
 }
 
 int cpu_irq_enable(void)
 {
+#ifdef CONFIG_IRQOFF_STATS
+	irqoff_end();
+#endif
+
 	return cpu_irq_set(CPU_IRQ_ENABLED);
 }
 
 int cpu_irq_disable(void)
 {
-	return cpu_irq_set(CPU_IRQ_DISABLED);
+	int flags;
+
+	flags = cpu_irq_set(CPU_IRQ_DISABLED);
+
+#ifdef CONFIG_IRQOFF_STATS
+	/* Only the outermost section is recorded */
+	if(flags == CPU_IRQ_ENABLED)
+		irqoff_begin(__builtin_return_address(0));
+#endif
+
+	return flags;
+}
+
+int cpu_irqoff_reset_stats(void)
+{
+#ifdef CONFIG_IRQOFF_STATS
+	unsigned int i;
+	int flags;
+
+	/* Durations are measured with the cycle counter */
+	if(dwt_cyccnt_enable() != 0)
+		return ENOTSUP;
+
+	flags = cpu_irq_set(CPU_IRQ_DISABLED);
+
+	irqoff_stats.count = 0;
+	irqoff_stats.max_cycles = 0;
+	irqoff_stats.max_site = NULL;
+	for(i = 0; i < CPU_IRQOFF_NB_BUCKETS; i++)
+		irqoff_stats.histogram[i] = 0;
+
+	irqoff_active = 0;
+	irqoff_recording = 1;
+
+	cpu_irq_set(flags);
+
+	return 0;
+#else
+	return ENOTSUP;
+#endif
+}
+
+int cpu_irqoff_get_stats(cpu_irqoff_stats *stats)
+{
+#ifdef CONFIG_IRQOFF_STATS
+	int flags;
+
+	if(stats == NULL)
+		return EINVAL;
+
+	/* Not recorded as a section, to leave the statistics unchanged */
+	flags = cpu_irq_set(CPU_IRQ_DISABLED);
+	*stats = irqoff_stats;
+	cpu_irq_set(flags);
+
+	return 0;
+#else
+	(void)stats;
+
+	return ENOTSUP;
+#endif
 }
 
 void cpu_dmb(void)
@@ -164,3 +295,12 @@ void cpu_set_privilege(unsigned int priv)
 
 	set_ctrl_reg(val);
 }
+
+int cpu_is_privileged(void)
+{
+	/* Handler mode is always privileged */
+	if(cpu_read_psr() & CPU_PSR_EXCEPTION_MASK)
+		return 1;
+
+	return !(get_ctrl_reg() & CPU_CTRL_REG_UNPRIV_BIT);
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file boot.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Boot timeline implementation
+ */
+#include <cpu/cpu_systick.h>
+#include <kernel/boot.h>
+#include <kernel/errno.h>
+#include <kernel/noinit.h>
+#include <kernel/stddef.h>
+#include <soc/soc_rcc.h>
+
+/*******************************************************************************
+ * Private definitions
+ ******************************************************************************/
+/** Boot timeline, recorded before .bss is cleared so kept out of it */
+typedef struct
+{
+	uint32_t last_val;      /**< SysTick value at last mark */
+	unsigned int freq;      /**< Current AHB clock frequency in Hz */
+	boot_phase_time phases[BOOT_NB_PHASES]; /**< Phase durations */
+} boot_timeline;
+
+/** Timeline of the last boot */
+static boot_timeline timeline NOINIT;
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+void boot_timer_start(void)
+{
+	unsigned int i;
+
+	for(i = 0; i < BOOT_NB_PHASES; i++)
+	{
+		timeline.phases[i].cycles = 0;
+		timeline.phases[i].us = 0;
+	}
+
+	/* The core runs from the internal oscillator out of reset */
+	timeline.freq = RCC_HSI_FREQ;
+	systick_start_counter();
+	timeline.last_val = systick_get_val();
+}
+
+void boot_mark(boot_phase phase)
+{
+	uint32_t val, cycles;
+
+	val = systick_get_val();
+	if(phase >= BOOT_NB_PHASES)
+		return;
+
+	/* SysTick counts down */
+	cycles = (timeline.last_val - val) & SYSTICK_VAL_MASK;
+	timeline.phases[phase].cycles = cycles;
+	/*
+	 * The clock in effect at the start of the phase is used, clock setup
+	 * spends most of its time waiting for oscillators before switching.
+	 * Clock frequencies are whole MHz, which avoids a 64-bit division.
+	 */
+	timeline.phases[phase].us = cycles / (timeline.freq / 1000000);
+
+	timeline.freq = rcc_get_hclk_freq();
+	timeline.last_val = systick_get_val();
+}
+
+int boot_get_phase_time(boot_phase phase, boot_phase_time *t)
+{
+	if((phase >= BOOT_NB_PHASES) || (t == NULL))
+		return EINVAL;
+
+	*t = timeline.phases[phase];
+
+	return 0;
+}
+
+uint32_t boot_get_total_us(void)
+{
+	uint32_t total = 0;
+	unsigned int i;
+
+	for(i = 0; i < BOOT_NB_PHASES; i++)
+		total += timeline.phases[i].us;
+
+	return total;
+}
@@ -2,6 +2,27 @@
 ROOT_DIR := $(shell dirname $(lastword $(MAKEFILE_LIST)))
 
 # List of object files to build in this directory
-OBJ += $(ROOT_DIR)/handlers.o $(ROOT_DIR)/entry.o $(ROOT_DIR)/irq.o            \
-       $(ROOT_DIR)/string.o $(ROOT_DIR)/list.o $(ROOT_DIR)/kalloc.o            \
-       $(ROOT_DIR)/sched.o
+OBJ += $(ROOT_DIR)/entry.o $(ROOT_DIR)/irq.o $(ROOT_DIR)/string.o              \
+       $(ROOT_DIR)/kalloc.o $(ROOT_DIR)/sched.o $(ROOT_DIR)/kdata.o            \
+       $(ROOT_DIR)/protect.o $(ROOT_DIR)/grant.o $(ROOT_DIR)/boot.o            \
+       $(ROOT_DIR)/pheap.o $(ROOT_DIR)/clock.o $(ROOT_DIR)/syscall.o
+
+# Kernel event tracing
+ifeq ($(TRACE), 1)
+OBJ += $(ROOT_DIR)/trace.o
+endif
+
+# Statistical profiler
+ifeq ($(PROFILE), 1)
+OBJ += $(ROOT_DIR)/prof.o
+endif
+
+# Time-triggered cyclic executive
+ifeq ($(CYCLIC), 1)
+OBJ += $(ROOT_DIR)/cyclic.o
+endif
+
+# Exception handlers, hosted builds get theirs from the host port
+ifneq ($(HOSTED), 1)
+OBJ += $(ROOT_DIR)/handlers.o
+endif
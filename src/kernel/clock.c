@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file clock.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Monotonic clock implementation
+ */
+#include <cpu/cpu_dwt.h>
+#include <cpu/cpu_scb.h>
+#include <cpu/cpu_systick.h>
+#include <kernel/clock.h>
+#include <kernel/errno.h>
+#include <kernel/stdint.h>
+#include <soc/soc_rcc.h>
+
+/*******************************************************************************
+ * Private definitions
+ ******************************************************************************/
+/** Number of fractional bits of the nanoseconds per cycle multiplier */
+#define CLOCK_NS_SHIFT (20)
+
+/** Nanoseconds per second */
+#define NS_PER_S (1000000000U)
+
+/**
+ * Tick count copies. The writer updates the copy readers are not using, then
+ * publishes it by incrementing the sequence number, so that a reader is never
+ * blocked by an interrupted writer.
+ */
+static volatile uint64_t latch_ticks[2];
+
+/** Sequence number, its lowest bit selects the current tick count copy */
+static volatile uint32_t latch_seq;
+
+/** Number of SysTick counter cycles per tick */
+static uint32_t period;
+
+/** SysTick counter clock frequency in Hz */
+static unsigned int freq;
+
+/** Nanoseconds per counter cycle, as a fixed point number */
+static uint32_t ns_mult;
+
+/** Nanoseconds per tick */
+static uint32_t tick_ns;
+
+/**
+ * Read the tick count and the number of cycles in the current tick
+ * \param[out] ticks The tick count
+ * \return The number of counter cycles elapsed since the last tick
+ */
+static uint32_t clock_read(uint64_t *ticks) RAMFUNC;
+static uint32_t clock_read(uint64_t *ticks)
+{
+	uint32_t seq, val;
+
+	do
+	{
+		seq = latch_seq;
+		*ticks = latch_ticks[seq & 1];
+		val = systick_get_val();
+
+		if(scb_is_systick_pending())
+		{
+			/*
+			 * The counter wrapped but the interrupt has not been
+			 * handled yet, read the counter again to make sure the
+			 * value belongs to the new period
+			 */
+			val = systick_get_val();
+			(*ticks)++;
+		}
+	} while(latch_seq != seq);
+
+	/* The counter counts down, reaching 0 ends a period */
+	return (val == 0) ? 0 : (period - val);
+}
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+int clock_init(void)
+{
+	uint32_t q, r;
+	unsigned int i;
+
+	freq = systick_get_clock_freq();
+	period = systick_get_period();
+	if((freq == 0) || (period == 0))
+		return EINVAL;
+
+	/*
+	 * Compute (NS_PER_S << CLOCK_NS_SHIFT) / freq by long division, 64-bit
+	 * division is not available without libgcc
+	 */
+	q = NS_PER_S / freq;
+	r = NS_PER_S % freq;
+	for(i = 0; i < CLOCK_NS_SHIFT; i++)
+	{
+		q <<= 1;
+		r <<= 1;
+		if(r >= freq)
+		{
+			r -= freq;
+			q |= 1;
+		}
+	}
+	ns_mult = q;
+
+	/* Rounded to the nearest nanosecond */
+	tick_ns = (((uint64_t)period * ns_mult) +
+	           (1U << (CLOCK_NS_SHIFT - 1))) >> CLOCK_NS_SHIFT;
+
+	latch_ticks[0] = 0;
+	latch_ticks[1] = 0;
+	latch_seq = 0;
+
+	/* Timestamps are core cycles where possible */
+	dwt_cyccnt_enable();
+
+	return 0;
+}
+
+void clock_tick(void)
+{
+	uint32_t seq;
+
+	seq = latch_seq;
+	latch_ticks[(seq + 1) & 1] = latch_ticks[seq & 1] + 1;
+	latch_seq = seq + 1;
+}
+
+uint64_t clock_get_ticks(void)
+{
+	uint64_t ticks;
+	uint32_t seq;
+
+	do
+	{
+		seq = latch_seq;
+		ticks = latch_ticks[seq & 1];
+	} while(latch_seq != seq);
+
+	return ticks;
+}
+
+uint64_t clock_get_cycles(void)
+{
+	uint64_t ticks;
+	uint32_t cycles;
+
+	cycles = clock_read(&ticks);
+
+	return (ticks * period) + cycles;
+}
+
+uint64_t clock_get_ns(void)
+{
+	uint64_t ticks;
+	uint32_t cycles;
+
+	cycles = clock_read(&ticks);
+
+	return (ticks * tick_ns) +
+	       (((uint64_t)cycles * ns_mult) >> CLOCK_NS_SHIFT);
+}
+
+unsigned int clock_get_freq(void)
+{
+	return freq;
+}
+
+uint32_t clock_get_timestamp(void)
+{
+	if(dwt_cyccnt_is_enabled())
+		return dwt_get_cyccnt();
+
+	return (uint32_t)clock_get_cycles();
+}
+
+unsigned int clock_get_timestamp_freq(void)
+{
+	return dwt_cyccnt_is_enabled() ? rcc_get_hclk_freq() : freq;
+}
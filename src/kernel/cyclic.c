@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file cyclic.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Time-triggered cyclic executive
+ */
+#include <cpu/cpu_utils.h>
+#include <kernel/clock.h>
+#include <kernel/cyclic.h>
+#include <kernel/errno.h>
+#include <kernel/sched.h>
+#include <kernel/string.h>
+
+/*******************************************************************************
+ * Private definitions
+ ******************************************************************************/
+/** No slot */
+#define CYCLIC_NO_SLOT (CYCLIC_MAX_SLOTS)
+
+/** Cyclic schedule, NULL until the executive is started */
+static const cyclic_table *table = NULL;
+
+/** Executive task */
+static task_t *executive_task;
+
+/** Ticks elapsed since the start of the frame */
+static uint32_t frame_tick;
+
+/** Next slot to start */
+static unsigned int next_slot;
+
+/** Ticks elapsed since the executive was started */
+static uint32_t now;
+
+/** Slot started and waiting for the executive, or #CYCLIC_NO_SLOT */
+static volatile unsigned int released = CYCLIC_NO_SLOT;
+
+/** Tick at which the released slot ends */
+static uint32_t released_end;
+
+/** Slot whose function is running, or #CYCLIC_NO_SLOT */
+static volatile unsigned int running = CYCLIC_NO_SLOT;
+
+/** Tick at which the running slot ends */
+static uint32_t running_end;
+
+/** True once the running slot overrun has been reported */
+static unsigned char running_overrun;
+
+/** Slot statistics */
+static cyclic_slot_stats stats[CYCLIC_MAX_SLOTS];
+
+/*******************************************************************************
+ * Private functions
+ ******************************************************************************/
+/**
+ * Check a cyclic schedule
+ * \param[in] t The cyclic schedule
+ * \return True if the schedule is valid, false otherwise
+ */
+static int table_is_valid(const cyclic_table *t)
+{
+	const cyclic_slot *s;
+	uint32_t end = 0;
+	unsigned int i;
+
+	if((t == NULL) || (t->frame_length == 0) || (t->nb_slots == 0) ||
+	   (t->nb_slots > CYCLIC_MAX_SLOTS) || (t->slots == NULL))
+		return 0;
+
+	/* Slots are ordered, do not overlap and fit in the frame */
+	for(i = 0; i < t->nb_slots; i++)
+	{
+		s = &t->slots[i];
+		if((s->f == NULL) || (s->length == 0) || (s->offset < end) ||
+		   (s->length > t->frame_length - s->offset))
+			return 0;
+
+		end = s->offset + s->length;
+	}
+
+	return 1;
+}
+
+/**
+ * Executive task, runs the functions of the slots as they start
+ * \param[in] arg Unused
+ */
+static void executive(void *arg)
+{
+	const cyclic_slot *s;
+	unsigned int slot;
+	uint32_t start, cycles;
+	int flags;
+
+	(void)arg;
+
+	while(1)
+	{
+		/* Sleep until a slot starts, irqs off not to miss it */
+		flags = cpu_irq_disable();
+		if(released == CYCLIC_NO_SLOT)
+			sched_sleep();
+		cpu_irq_restore(flags);
+
+		flags = cpu_irq_disable();
+		slot = released;
+		released = CYCLIC_NO_SLOT;
+		if(slot != CYCLIC_NO_SLOT)
+		{
+			running = slot;
+			running_end = released_end;
+			running_overrun = 0;
+		}
+		cpu_irq_restore(flags);
+
+		if(slot == CYCLIC_NO_SLOT)
+			continue;
+
+		s = &table->slots[slot];
+		start = clock_get_timestamp();
+		s->f(s->arg);
+		cycles = clock_get_timestamp() - start;
+
+		flags = cpu_irq_disable();
+		running = CYCLIC_NO_SLOT;
+		stats[slot].runs++;
+		if(cycles > stats[slot].max_cycles)
+			stats[slot].max_cycles = cycles;
+		cpu_irq_restore(flags);
+	}
+}
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+int cyclic_start(const cyclic_table *t)
+{
+	task_t *task;
+
+	if(!table_is_valid(t))
+		return EINVAL;
+
+	if(table)
+		return EBUSY;
+
+	task = sched_create_task(executive, NULL, t->stack_size, 1, 0);
+	if(task == NULL)
+		return ENOMEM;
+
+	memset(stats, 0x00, sizeof(stats));
+
+	/* The next tick starts the first frame */
+	executive_task = task;
+	frame_tick = t->frame_length - 1;
+	next_slot = 0;
+	table = t;
+
+	/* Slots run ahead of any other task */
+	sched_set_time_triggered(task);
+
+	return 0;
+}
+
+int cyclic_get_stats(unsigned int slot, cyclic_slot_stats *s)
+{
+	int flags;
+
+	if((s == NULL) || (table == NULL) || (slot >= table->nb_slots))
+		return EINVAL;
+
+	flags = cpu_irq_disable();
+	*s = stats[slot];
+	cpu_irq_restore(flags);
+
+	return 0;
+}
+
+void cyclic_tick(void)
+{
+	const cyclic_slot *s;
+
+	if(table == NULL)
+		return;
+
+	now++;
+	if(++frame_tick >= table->frame_length)
+		frame_tick = 0;
+
+	/* Report a slot function still running at the end of its slot, once */
+	if((running != CYCLIC_NO_SLOT) && !running_overrun &&
+	   ((int32_t)(now - running_end) >= 0))
+	{
+		running_overrun = 1;
+		stats[running].overruns++;
+		if(table->overrun)
+			table->overrun(running);
+	}
+
+	s = &table->slots[next_slot];
+	if(frame_tick != s->offset)
+		return;
+
+	/* A slot the executive had no time to start is dropped */
+	if(released != CYCLIC_NO_SLOT)
+		stats[released].skipped++;
+
+	released = next_slot;
+	released_end = now + s->length;
+	if(++next_slot >= table->nb_slots)
+		next_slot = 0;
+
+	sched_wakeup(executive_task);
+}
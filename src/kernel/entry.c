@@ -31,14 +31,34 @@
  */
 #include <cpu/cpu_systick.h>
 #include <cpu/cpu_utils.h>
+#include <kernel/boot.h>
+#include <kernel/clock.h>
 #include <kernel/string.h>
 #include <kernel/stdint.h>
 #include <kernel/kalloc.h>
+#include <kernel/kdata.h>
+#include <kernel/prof.h>
+#include <kernel/protect.h>
 #include <kernel/sched.h>
+#include <kernel/trace.h>
+#include <soc/soc_rcc.h>
+#ifdef CONFIG_BENCH
+#include <bench/bench.h>
+#endif
+#ifdef CONFIG_STRESS
+#include <posix/posix_stress.h>
+#endif
+
+/** Frequency of the external oscillator of the board in Hz */
+#define BOARD_HSE_FREQ (8000000)
+
+/** Frequency of the scheduler tick in Hz */
+#define SCHED_TICK_FREQ (100)
 
 /* Linker-defined section symbols */
 extern uint32_t __ram_data_start, __ram_data_end, __rodata_end, __bss_start,
-                __bss_end;
+                __bss_end, __ramfunc_start, __ramfunc_end, __ramfunc_load,
+                __stack_limit;
 
 /*
  * Dummy stack to save main task context on first context switch, even though it
@@ -50,25 +70,72 @@ void kernel_entry(void)
 {
 	unsigned char *sp;
 
+	/* Timestamp boot phases, until the scheduler takes SysTick over */
+	boot_timer_start();
+
 	/* Initialize data segment */
 	memcpy(&__ram_data_start, &__rodata_end,
 	       (unsigned char *)(&__ram_data_end) - (unsigned char *)(&__ram_data_start));
+	/* Copy code that executes from SRAM */
+	memcpy(&__ramfunc_start, &__ramfunc_load,
+	       (unsigned char *)(&__ramfunc_end) -
+	       (unsigned char *)(&__ramfunc_start));
 	/* Initialize BSS */
 	memset(&__bss_start, 0x00,
 	       (unsigned char *)(&__bss_end) - (unsigned char *)(&__bss_start));
+	boot_mark(BOOT_PHASE_SECTIONS);
 
-	/* Initialize memory allocator */
-	kalloc_init();
+	/*
+	 * Clock the core at full speed. On failure, the system keeps running
+	 * from the internal oscillator and published frequencies reflect it.
+	 * Emulated boards have no STM32 clock tree to configure.
+	 */
+#ifndef CONFIG_QEMU
+	rcc_setup(BOARD_HSE_FREQ, RCC_MAX_SYSCLK_FREQ);
+#endif
+	boot_mark(BOOT_PHASE_CLOCK);
+
+	/* Heap starts at end of BSS and ends at the top of the stack space */
+	kalloc_init(&__bss_end,
+	            (unsigned char *)(&__stack_limit) -
+	            (unsigned char *)(&__bss_end));
+	boot_mark(BOOT_PHASE_KALLOC);
+
+	/* Enable memory protection, if available */
+	protect_init();
+	boot_mark(BOOT_PHASE_PROTECT);
 
 	/* Initialize scheduler */
 	sched_init();
+#ifdef CONFIG_BENCH
+	sched_create_task(bench_main, NULL, BENCH_STACK_SIZE, 1, 0);
+#endif
+#ifdef CONFIG_STRESS
+	sched_create_task(posix_stress_main, NULL, POSIX_STRESS_STACK_SIZE, 1,
+	                  0);
+#endif
 	sp = ((unsigned char *)dummy_stack) + sizeof(dummy_stack);
 	CPU_SET_PSP(sp);
+	boot_mark(BOOT_PHASE_SCHED);
 
 	/* Setup SysTick to start scheduling */
-	systick_setup(100, 8000000);
+	systick_setup(SCHED_TICK_FREQ, rcc_get_hclk_freq());
+	clock_init();
+#ifdef CONFIG_TRACE
+	trace_init();
+#endif
+#ifdef CONFIG_PROFILE
+	prof_init();
+#endif
+#ifdef CONFIG_IRQOFF_STATS
+	cpu_irqoff_reset_stats();
+#endif
+	kdata_init(systick_get_freq());
 	systick_enable();
 
+	/* Switch to the first task now rather than on the first tick */
+	sched_yield();
+
 	while(1)
 		;
 }
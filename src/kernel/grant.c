@@ -0,0 +1,319 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file grant.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Zero-copy buffer sharing between tasks
+ *
+ * Grantable buffers are the 8 subregions of a single MPU region which denies
+ * access to unprivileged code. On task switch, the subregions holding buffers
+ * of the new task are disabled so that accesses fall back to the background
+ * SRAM region. Lending a buffer thus only moves access rights, no byte is
+ * copied.
+ *
+ * Tasks reach the buffer functions through system calls, since they program
+ * the MPU.
+ */
+#include <cpu/cpu_mpu.h>
+#include <cpu/cpu_utils.h>
+#include <kernel/errno.h>
+#include <kernel/grant.h>
+#include <kernel/kalloc.h>
+#include <kernel/protect.h>
+#include <kernel/stdint.h>
+#include <kernel/syscall.h>
+
+/*******************************************************************************
+ * Private definitions
+ ******************************************************************************/
+/** Attributes of the grant pool region */
+#define GRANT_POOL_ATTR (MPU_ATTR_AP_PRIV_RW | MPU_ATTR_XN | MPU_ATTR_SRAM)
+
+/** Grantable buffer */
+typedef struct
+{
+	const task_t *owner;     /**< Owner of the buffer, NULL if free */
+	const task_t *holder;    /**< Task allowed to access the buffer */
+} grant_buffer;
+
+/** Grantable buffers */
+static grant_buffer buffers[GRANT_NB_BUFFERS];
+
+/** Grant pool, NULL if not allocated */
+static char *pool = NULL;
+
+/** Size of a buffer in bytes */
+static size_t buffer_size;
+
+/** Precomputed grant pool region, with all subregions enabled */
+static mpu_region_t pool_region;
+
+/**
+ * Get the index of a buffer in the pool
+ * \param[in] buf Pointer to the buffer
+ * \return The index of the buffer, -1 if buf is not a buffer of the pool
+ */
+static int buffer_index(void *buf)
+{
+	char *p;
+
+	p = buf;
+
+	if((pool == NULL) || (p < pool) ||
+	   (p >= pool + (GRANT_NB_BUFFERS * buffer_size)) ||
+	   ((p - pool) % buffer_size))
+	{
+		return -1;
+	}
+
+	return ((p - pool) / buffer_size);
+}
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+int grant_init(size_t buf_size)
+{
+	size_t pool_size;
+	char *p;
+
+	/* Each buffer is a subregion of the pool region */
+	pool_size = GRANT_NB_BUFFERS * buf_size;
+	if((pool_size < MPU_MIN_SUBREGION_REGION_SIZE) ||
+	   (buf_size & (buf_size - 1)))
+	{
+		return EINVAL;
+	}
+
+	if(pool != NULL)
+	{
+		return EBUSY;
+	}
+
+	/* The MPU requires the region to be aligned on its size */
+	p = kmalloc_aligned(pool_size, pool_size);
+	if(p == NULL)
+	{
+		return ENOMEM;
+	}
+
+	if(protect_is_enabled())
+	{
+		mpu_region_compute(PROTECT_REGION_GRANT, p, pool_size,
+		                   GRANT_POOL_ATTR, &pool_region);
+	}
+
+	buffer_size = buf_size;
+	pool = p;
+
+	grant_switch(sched_get_current_task());
+
+	return 0;
+}
+
+void * grant_alloc(void)
+{
+	return (void *)__do_svc(0, 0, 0, 0, SYSCALL_GRANT_ALLOC);
+}
+
+int grant_lend(void *buf, task_t *t)
+{
+	return __do_svc((uintptr_t)buf, (uintptr_t)t, 0, 0, SYSCALL_GRANT_LEND);
+}
+
+int grant_return(void *buf)
+{
+	return __do_svc((uintptr_t)buf, 0, 0, 0, SYSCALL_GRANT_RETURN);
+}
+
+int grant_free(void *buf)
+{
+	return __do_svc((uintptr_t)buf, 0, 0, 0, SYSCALL_GRANT_FREE);
+}
+
+void * grant_do_alloc(void)
+{
+	const task_t *t;
+	int flags;
+	int i;
+
+	t = sched_get_current_task();
+	flags = cpu_irq_disable();
+
+	for(i = 0; (pool != NULL) && (i < GRANT_NB_BUFFERS); i++)
+	{
+		if(buffers[i].owner == NULL)
+		{
+			buffers[i].owner = t;
+			buffers[i].holder = t;
+			grant_switch(t);
+			cpu_irq_restore(flags);
+
+			return (pool + (i * buffer_size));
+		}
+	}
+
+	cpu_irq_restore(flags);
+
+	return NULL;
+}
+
+int grant_do_lend(void *buf, task_t *t)
+{
+	const task_t *cur;
+	int flags;
+	int i;
+
+	i = buffer_index(buf);
+	if((i < 0) || (t == NULL))
+	{
+		return EINVAL;
+	}
+
+	cur = sched_get_current_task();
+	flags = cpu_irq_disable();
+
+	if((buffers[i].owner != cur) || (buffers[i].holder != cur))
+	{
+		cpu_irq_restore(flags);
+		return EPERM;
+	}
+
+	buffers[i].holder = t;
+	grant_switch(cur);
+	cpu_irq_restore(flags);
+
+	return 0;
+}
+
+int grant_do_return(void *buf)
+{
+	const task_t *cur;
+	int flags;
+	int i;
+
+	i = buffer_index(buf);
+	if(i < 0)
+	{
+		return EINVAL;
+	}
+
+	cur = sched_get_current_task();
+	flags = cpu_irq_disable();
+
+	if((buffers[i].owner == NULL) || (buffers[i].holder != cur))
+	{
+		cpu_irq_restore(flags);
+		return EPERM;
+	}
+
+	buffers[i].holder = buffers[i].owner;
+	grant_switch(cur);
+	cpu_irq_restore(flags);
+
+	return 0;
+}
+
+int grant_do_free(void *buf)
+{
+	const task_t *cur;
+	int flags;
+	int i;
+
+	i = buffer_index(buf);
+	if(i < 0)
+	{
+		return EINVAL;
+	}
+
+	cur = sched_get_current_task();
+	flags = cpu_irq_disable();
+
+	if((buffers[i].owner != cur) || (buffers[i].holder != cur))
+	{
+		cpu_irq_restore(flags);
+		return EPERM;
+	}
+
+	buffers[i].owner = NULL;
+	buffers[i].holder = NULL;
+	grant_switch(cur);
+	cpu_irq_restore(flags);
+
+	return 0;
+}
+
+void grant_switch(const task_t *t)
+{
+	mpu_region_t r;
+	unsigned int mask;
+	int i;
+
+	if((pool == NULL) || !protect_is_enabled())
+	{
+		return;
+	}
+
+	/* Open the subregions of the buffers held by the task */
+	mask = 0;
+	for(i = 0; i < GRANT_NB_BUFFERS; i++)
+	{
+		if(buffers[i].holder == t)
+		{
+			mask |= (1U << i);
+		}
+	}
+
+	r.rbar = pool_region.rbar;
+	r.rasr = pool_region.rasr | MPU_ATTR_SRD(mask);
+	mpu_region_load(&r);
+}
+
+void grant_release_task(const task_t *t)
+{
+	int i;
+
+	for(i = 0; i < GRANT_NB_BUFFERS; i++)
+	{
+		if(buffers[i].holder == t)
+		{
+			/* Borrowed buffers go back to their owner */
+			buffers[i].holder = buffers[i].owner;
+		}
+
+		if(buffers[i].owner == t)
+		{
+			/* Owned buffers go to their borrower or are freed */
+			buffers[i].owner = buffers[i].holder;
+			if(buffers[i].holder == t)
+			{
+				buffers[i].owner = NULL;
+				buffers[i].holder = NULL;
+			}
+		}
+	}
+}
@@ -29,10 +29,17 @@
  * \author Maxime Bernelas <maxime@bernelas.fr>
  * Exception handlers implementation
  */
+#include <cpu/cpu_scb.h>
 #include <cpu/cpu_utils.h>
 #include <cpu/cpu_task.h>
+#include <kernel/clock.h>
+#include <kernel/cyclic.h>
 #include <kernel/handlers.h>
+#include <kernel/prof.h>
+#include <kernel/kdata.h>
 #include <kernel/sched.h>
+#include <kernel/syscall.h>
+#include <kernel/trace.h>
 
 /*******************************************************************************
  * Private definitions
@@ -69,6 +76,50 @@ static void dummy_handler(void *sp)
 		;
 }
 
+/** Information about the last memory management fault */
+typedef struct
+{
+	fault_info_t info;      /**< Fault information */
+	task_t *task;           /**< Task running when the fault occurred */
+	int stack_overflow;     /**< True if the task overflowed its stack */
+} mem_fault_report;
+
+/** Last memory management fault, to be inspected with a debugger */
+static volatile mem_fault_report mem_fault;
+
+/**
+ * Memory management fault handler
+ * \param[in] sp Value of the stack pointer on fault entry
+ */
+static void mem_manage_handler(void *sp) __attribute__((used));
+static void mem_manage_handler(void *sp)
+{
+	cpu_ex_stack_frame *frame;
+	fault_info_t info;
+	task_t *t;
+	void *pc;
+
+	frame = sp;
+	t = sched_get_current_task();
+	pc = NULL;
+
+	/* The exception frame cannot be read if it was stacked in the guard */
+	if(!sched_is_stack_guard(t, frame))
+	{
+		pc = (void *)(uintptr_t)frame->pc;
+	}
+
+	scb_get_mem_manage_fault_information(pc, &info);
+
+	mem_fault.info = info;
+	mem_fault.task = t;
+	mem_fault.stack_overflow = (sched_is_stack_guard(t, frame) ||
+	                            sched_is_stack_guard(t, info.address));
+
+	while(1)
+		;
+}
+
 /*******************************************************************************
  * Public functions
  ******************************************************************************/
@@ -85,7 +136,7 @@ void handler_hard_fault(void)
 
 void handler_memmanage(void)
 {
-	CALL_WITH_STACK_POINTER(dummy_handler);
+	CALL_WITH_STACK_POINTER(mem_manage_handler);
 }
 
 void handler_busfault(void)
@@ -98,16 +149,16 @@ void handler_usage(void)
 	CALL_WITH_STACK_POINTER(dummy_handler);
 }
 
-int handler_svc(uint32_t p1, uint32_t p2, uint32_t p3, uint32_t p4,
-                uint32_t num)
+uint32_t handler_svc(uint32_t p1, uint32_t p2, uint32_t p3, uint32_t p4,
+                     uint32_t num)
 {
-	(void)num;
-	(void)p1;
-	(void)p2;
-	(void)p3;
-	(void)p4;
+	uint32_t ret;
+
+	TRACE(TRACE_SVC_ENTER, num, 0);
+	ret = syscall_dispatch(p1, p2, p3, p4, num);
+	TRACE(TRACE_SVC_EXIT, num, ret);
 
-	return 0;
+	return ret;
 }
 
 void handler_pendSV(void)
@@ -124,6 +175,15 @@ void handler_pendSV(void)
 
 void handler_systick(void)
 {
-	/* Release processor to next task */
-	sched_yield();
+	/* Account time first, readers rely on it once the interrupt is taken */
+	clock_tick();
+#ifdef CONFIG_PROFILE
+	/* LR holds the EXC_RETURN value on entry */
+	prof_sample((uint32_t)__builtin_return_address(0));
+#endif
+	kdata_tick();
+	sched_tick();
+#ifdef CONFIG_CYCLIC
+	cyclic_tick();
+#endif
 }
@@ -31,9 +31,11 @@
  */
 #include <cpu/cpu_interrupts.h>
 #include <cpu/cpu_utils.h>
+#include <kernel/clock.h>
 #include <kernel/stddef.h>
 #include <kernel/irq.h>
 #include <kernel/errno.h>
+#include <kernel/trace.h>
 
 /*******************************************************************************
  * Private definitions
@@ -43,11 +45,19 @@ typedef struct
 {
 	irq_handler handler;  /**< IRQ handler */
 	void *data;           /**< IRQ handler parameter */
+#ifdef CONFIG_IRQ_STATS
+	irq_stats stats;      /**< IRQ statistics */
+#endif
 } irq_slot;
 
 /** Array of registered IRQ handlers */
 static irq_slot slots[CPU_INT_NB_IRQ];
 
+#ifdef CONFIG_IRQ_STATS
+/** Current interrupt nesting level */
+static unsigned int nesting;
+#endif
+
 /*******************************************************************************
  * Public definitions
  ******************************************************************************/
@@ -91,13 +101,88 @@ int irq_release(int irq)
 	return 0;
 }
 
+int irq_get_stats(int irq, irq_stats *stats)
+{
+#ifdef CONFIG_IRQ_STATS
+	int flags;
+
+	if((irq < 0) || (irq > CPU_INT_NB_IRQ - 1) || (stats == NULL))
+	{
+		return EINVAL;
+	}
+
+	flags = cpu_irq_disable();
+	*stats = slots[irq].stats;
+	cpu_irq_restore(flags);
+
+	return 0;
+#else
+	(void)irq;
+	(void)stats;
+
+	return ENOTSUP;
+#endif
+}
+
+int irq_reset_stats(int irq)
+{
+#ifdef CONFIG_IRQ_STATS
+	int flags;
+
+	if((irq < 0) || (irq > CPU_INT_NB_IRQ - 1))
+	{
+		return EINVAL;
+	}
+
+	flags = cpu_irq_disable();
+	slots[irq].stats.count = 0;
+	slots[irq].stats.total_cycles = 0;
+	slots[irq].stats.max_cycles = 0;
+	slots[irq].stats.max_nesting = 0;
+	cpu_irq_restore(flags);
+
+	return 0;
+#else
+	(void)irq;
+
+	return ENOTSUP;
+#endif
+}
+
 void handler_interrupt(void)
 {
 	int irq;
+#ifdef CONFIG_IRQ_STATS
+	irq_stats *stats;
+	uint32_t start, cycles;
+#endif
 
 	/* Find the IRQ number */
 	irq = (cpu_read_psr() & 0xFF) - CPU_INT_IRQ_BASE_INDEX;
 
+#ifdef CONFIG_IRQ_STATS
+	stats = &slots[irq].stats;
+	nesting++;
+	if(nesting > stats->max_nesting)
+		stats->max_nesting = nesting;
+	start = clock_get_timestamp();
+#endif
+
 	/* Call the registered handler */
+	TRACE(TRACE_IRQ_ENTER, irq, 0);
 	slots[irq].handler(slots[irq].data);
+	TRACE(TRACE_IRQ_EXIT, irq, 0);
+
+#ifdef CONFIG_IRQ_STATS
+	/*
+	 * Only interrupts with a higher priority touch these while this one is
+	 * running, and they leave them as they found them
+	 */
+	cycles = clock_get_timestamp() - start;
+	nesting--;
+	stats->count++;
+	stats->total_cycles += cycles;
+	if(cycles > stats->max_cycles)
+		stats->max_cycles = cycles;
+#endif
 }
@@ -29,20 +29,24 @@
  * \author Maxime Bernelas <maxime@bernelas.fr>
  * Kernel memory allocator implementation
  */
+#include <cpu/cpu_utils.h>
+#include <kernel/errno.h>
 #include <kernel/string.h>
 #include <kernel/kalloc.h>
 #include <kernel/list.h>
 #include <kernel/stddef.h>
 #include <kernel/stdint.h>
-
-/* Linker-defined symbols */
-extern uint32_t __stack_limit, __bss_end;
+#include <kernel/trace.h>
 
 /*******************************************************************************
  * Private definitions
  ******************************************************************************/
 /** Allocated blocks alignment in bytes */
-#define KALLOC_ALIGN (sizeof(int))
+#define KALLOC_ALIGN (sizeof(void *))
+
+/** Round a pointer up to a multiple of a (power of 2) */
+#define ALIGN_UP(p, a)                                                         \
+	((char *)(((uintptr_t)(p) + ((a) - 1)) & ~(uintptr_t)((a) - 1)))
 
 /** Block states */
 typedef enum
@@ -58,23 +62,27 @@ typedef struct
 	block_state state;      /**< State of the block */
 } block_info;
 
-/** Linked list of memory blocks */
-static block_info *first_block = NULL;
+/** List of memory blocks, sorted by address */
+static list_item block_list = LIST_INIT(block_list);
+
+/** End of the heap, the last block ends there */
+static char *heap_end;
 
 /**
  * Computes the size of a block
  * \param[in] b Pointer to the block
  * \return The size of the block in bytes
  */
+static size_t block_size(block_info *b) RAMFUNC;
 static size_t block_size(block_info *b)
 {
 	char *start, *end;
 
 	start = (char *)b;
 
-	if(b->node.next == NULL)
+	if(b->node.next == &block_list)
 	{
-		end = (char *)&__stack_limit;
+		end = heap_end;
 	}
 	else
 	{
@@ -89,6 +97,7 @@ static size_t block_size(block_info *b)
  * \param[in] b Pointer to the block
  * \return The usable size of the block in bytes
  */
+static size_t usable_block_size(block_info *b) RAMFUNC;
 static size_t usable_block_size(block_info *b)
 {
 	return (block_size(b) - sizeof(*b));
@@ -100,6 +109,7 @@ static size_t usable_block_size(block_info *b)
  * \param[in] n Target usable size of the block
  * \note This function assumes that the usable size of the block b is at least n
  */
+static void block_split(block_info *b, size_t n) RAMFUNC;
 static void block_split(block_info *b, size_t n)
 {
 	block_info *new_block;
@@ -128,11 +138,12 @@ static void block_split(block_info *b, size_t n)
  * \retval 1 The block can be merged
  * \note This function assumes that b is not NULL
  */
+static int can_merge_with_next(block_info *b) RAMFUNC;
 static int can_merge_with_next(block_info *b)
 {
 	block_info *next_block;
 
-	if((b->state == STATE_FREE) && (b->node.next != NULL))
+	if((b->state == STATE_FREE) && (b->node.next != &block_list))
 	{
 		next_block = LIST_GET_OBJECT(b->node.next, block_info, node);
 
@@ -142,29 +153,31 @@ static int can_merge_with_next(block_info *b)
 	return 0;
 }
 
-/** Merge adjacent free blocks in list of blocks */
-static void merge_blocks(void)
+/**
+ * Merge a free block with its free neighbours
+ * \param[in] b The block to merge
+ * \note Adjacent blocks are never both free, so only the direct neighbours of
+ * a newly freed block need to be looked at
+ */
+static void merge_block(block_info *b) RAMFUNC;
+static void merge_block(block_info *b)
 {
-	list_item *cur_node;
-	block_info *cur_block;
+	/*
+	 * Merging a block is equivalent to removing the next block from the
+	 * list
+	 */
+	if(can_merge_with_next(b))
+	{
+		list_remove(b->node.next);
+	}
 
-	cur_node = &(first_block->node);
-	while(cur_node)
+	if(b->node.prev != &block_list)
 	{
-		cur_block = LIST_GET_OBJECT(cur_node, block_info, node);
+		b = LIST_GET_OBJECT(b->node.prev, block_info, node);
 
-		if(can_merge_with_next(cur_block))
-		{
-			/* 
-			 * Merge the block, it is equivalent to removing
-			 * the next block from the list
-			 */
-			list_remove(&cur_node, cur_block->node.next);
-		}
-		else
+		if(can_merge_with_next(b))
 		{
-			/* Advance to next block */
-			cur_node = cur_node->next;
+			list_remove(b->node.next);
 		}
 	}
 }
@@ -172,41 +185,94 @@ static void merge_blocks(void)
 /*******************************************************************************
  * Public functions
  ******************************************************************************/
-int kalloc_init(void)
+int kalloc_init(void *start, size_t size)
 {
-	/* Initialize the memory allocator data structures */
-	/* Heap starts at end of BSS and ends at the top of the stack space */
-	first_block = (block_info *)&__bss_end;
-	first_block->node.next = NULL;
-	first_block->node.prev = NULL;
+	block_info *first_block;
+	char *end;
+
+	/* Keep blocks aligned whatever the bounds of the area */
+	end = (char *)start + size;
+	start = ALIGN_UP(start, KALLOC_ALIGN);
+	end = (char *)((uintptr_t)end & ~(uintptr_t)(KALLOC_ALIGN - 1));
+	if((end < (char *)start) ||
+	   ((size_t)(end - (char *)start) <= sizeof(block_info)))
+	{
+		return EINVAL;
+	}
+
+	/* The whole area is a single free block */
+	first_block = start;
 	first_block->state = STATE_FREE;
+	heap_end = end;
+	list_init(&block_list);
+	list_add_tail(&block_list, &first_block->node);
+
+	return 0;
+}
+
+int kalloc_get_stats(kalloc_stats *stats)
+{
+	block_info *b;
+	size_t size;
+	int flags;
+
+	if(stats == NULL)
+	{
+		return EINVAL;
+	}
+
+	/* Unprivileged tasks cannot mask IRQs, see kalloc.h */
+	if(!cpu_is_privileged())
+	{
+		return EPERM;
+	}
+
+	flags = cpu_irq_disable();
+
+	stats->free_bytes = 0;
+	stats->largest_free = 0;
+	stats->nb_blocks = 0;
+	stats->nb_free_blocks = 0;
+
+	LIST_FOR_EACH_OBJECT(b, &block_list, block_info, node)
+	{
+		stats->nb_blocks++;
+		if(b->state != STATE_FREE)
+			continue;
+
+		size = usable_block_size(b);
+		stats->nb_free_blocks++;
+		stats->free_bytes += size;
+		if(size > stats->largest_free)
+			stats->largest_free = size;
+	}
+
+	cpu_irq_restore(flags);
 
 	return 0;
 }
 
 void * kmalloc(size_t n)
 {
-	list_item *cur_node;
-	block_info *best;
+	block_info *b, *best;
+	int flags;
 
-	if(n == 0)
+	if((n == 0) || !cpu_is_privileged())
 	{
 		return NULL;
 	}
 
 	/* Round the size to keep blocks aligned */
-	n = ((KALLOC_ALIGN * n) + (KALLOC_ALIGN - 1)) / KALLOC_ALIGN;
+	n = ((n + (KALLOC_ALIGN - 1)) / KALLOC_ALIGN) * KALLOC_ALIGN;
+
+	/* Masked, the scheduler cannot free a task while the heap changes */
+	flags = cpu_irq_disable();
 
 	/* Find the best fitting free block */
-	cur_node = &(first_block->node);
 	best = NULL;
 
-	while(cur_node)
+	LIST_FOR_EACH_OBJECT(b, &block_list, block_info, node)
 	{
-		block_info *b;
-
-		b = LIST_GET_OBJECT(cur_node, block_info, node);
-
 		if((b->state == STATE_FREE) && (usable_block_size(b) >= n))
 		{
 			if(best == NULL)
@@ -219,13 +285,12 @@ void * kmalloc(size_t n)
 				best = b;
 			}
 		}
-
-		cur_node = cur_node->next;
 	}
 
 	/* Search is finished */
 	if(best == NULL)
 	{
+		cpu_irq_restore(flags);
 		return NULL;
 	}
 
@@ -234,6 +299,99 @@ void * kmalloc(size_t n)
 
 	/* Mark block as used and return the pointer to usable data */
 	best->state = STATE_USED;
+	TRACE(TRACE_ALLOC, n, best + 1);
+
+	cpu_irq_restore(flags);
+
+	return (best + 1);
+}
+
+void * kmalloc_aligned(size_t n, size_t align)
+{
+	block_info *b, *best;
+	char *best_data;
+	int flags;
+
+	if((n == 0) || (align == 0) || (align & (align - 1)) ||
+	   !cpu_is_privileged())
+	{
+		return NULL;
+	}
+
+	if(align < KALLOC_ALIGN)
+	{
+		align = KALLOC_ALIGN;
+	}
+
+	/* Round the size to keep blocks aligned */
+	n = ((n + (KALLOC_ALIGN - 1)) / KALLOC_ALIGN) * KALLOC_ALIGN;
+
+	/* Masked, the scheduler cannot free a task while the heap changes */
+	flags = cpu_irq_disable();
+
+	/* Find the best fitting free block */
+	best = NULL;
+	best_data = NULL;
+
+	LIST_FOR_EACH_OBJECT(b, &block_list, block_info, node)
+	{
+		char *data, *end;
+
+		if(b->state != STATE_FREE)
+		{
+			continue;
+		}
+
+		data = ALIGN_UP((char *)(b + 1), align);
+		if(data != (char *)(b + 1))
+		{
+			/*
+			 * Leave room for a free block in front of the aligned
+			 * block
+			 */
+			data = ALIGN_UP((char *)(b + 2), align);
+		}
+
+		end = ((char *)b) + block_size(b);
+		if((data > end) || ((size_t)(end - data) < n))
+		{
+			continue;
+		}
+
+		if((best == NULL) || (block_size(b) < block_size(best)))
+		{
+			/* This one fits best */
+			best = b;
+			best_data = data;
+		}
+	}
+
+	/* Search is finished */
+	if(best == NULL)
+	{
+		cpu_irq_restore(flags);
+		return NULL;
+	}
+
+	if(best_data != (char *)(best + 1))
+	{
+		block_info *aligned;
+
+		/* Leading space becomes a free block of its own */
+		aligned = ((block_info *)best_data) - 1;
+		aligned->state = STATE_FREE;
+		list_insert_after(&(best->node), &(aligned->node));
+		best = aligned;
+	}
+
+	/* Adjust the block to the requested size */
+	block_split(best, n);
+
+	/* Mark block as used and return the pointer to usable data */
+	best->state = STATE_USED;
+	TRACE(TRACE_ALLOC, n, best + 1);
+
+	cpu_irq_restore(flags);
 
 	return (best + 1);
 }
@@ -255,19 +413,26 @@ void * kcalloc(size_t n)
 void kfree(void *p)
 {
 	block_info *b;
+	int flags;
 
-	if(p == NULL)
+	if((p == NULL) || !cpu_is_privileged())
 	{
 		return;
 	}
 
+	TRACE(TRACE_FREE, 0, p);
+
 	/* Retrieve the block info pointer */
 	b = p;
 	b--;
 
+	flags = cpu_irq_disable();
+
 	/* Mark block as free */
 	b->state = STATE_FREE;
 
 	/* Merge free blocks */
-	merge_blocks();
+	merge_block(b);
+
+	cpu_irq_restore(flags);
 }
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file kdata.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Kernel data block management
+ */
+#include <cpu/cpu_mpu.h>
+#include <kernel/kdata.h>
+#include <kernel/protect.h>
+
+/*******************************************************************************
+ * Private definitions
+ ******************************************************************************/
+/** Writable view of the kernel data block */
+static volatile kdata_t kdata_rw;
+
+/*
+ * Tasks see the read-only view only. Fields are only updated from SysTick and
+ * PendSV handlers, which do not preempt each other, and as volatile accesses
+ * are not reordered by the compiler and the CPU has a single core, the
+ * sequence number is enough to get a consistent snapshot.
+ */
+extern const volatile kdata_t kdata __attribute__((alias("kdata_rw")));
+
+/** Mark the beginning of an update of the kernel data block */
+static void kdata_write_begin(void)
+{
+	kdata_rw.seq++;
+}
+
+/** Mark the end of an update of the kernel data block */
+static void kdata_write_end(void)
+{
+	kdata_rw.seq++;
+}
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+int kdata_init(unsigned int tick_freq)
+{
+	kdata_write_begin();
+	kdata_rw.tick_freq = tick_freq;
+	kdata_write_end();
+
+	/* Map the block read-only for unprivileged tasks */
+	if(protect_is_enabled())
+	{
+		mpu_region_setup(PROTECT_REGION_KDATA, (void *)&kdata_rw,
+		                 sizeof(kdata_rw), MPU_ATTR_AP_PRIV_RW_USER_RO |
+		                 MPU_ATTR_XN | MPU_ATTR_SRAM);
+	}
+
+	return 0;
+}
+
+void kdata_tick(void)
+{
+	kdata_write_begin();
+	kdata_rw.ticks++;
+	kdata_write_end();
+}
+
+void kdata_set_current_task(const task_t *t)
+{
+	kdata_write_begin();
+	kdata_rw.current = t;
+	kdata_write_end();
+}
+
+void kdata_set_load(uint32_t load)
+{
+	kdata_write_begin();
+	kdata_rw.load = load;
+	kdata_write_end();
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file pheap.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Pairing heap implementation
+ */
+#include <kernel/pheap.h>
+#include <kernel/stddef.h>
+
+/*******************************************************************************
+ * Private functions
+ ******************************************************************************/
+/**
+ * Merge two heaps
+ * \param[in] h The heap the items belong to (for comparison)
+ * \param[in] a Root of the first heap, with no sibling
+ * \param[in] b Root of the second heap, with no sibling
+ * \return Root of the merged heap
+ */
+static pheap_item *merge(pheap *h, pheap_item *a, pheap_item *b) RAMFUNC;
+static pheap_item *merge(pheap *h, pheap_item *a, pheap_item *b)
+{
+	pheap_item *tmp;
+
+	if(a == NULL)
+		return b;
+
+	if(b == NULL)
+		return a;
+
+	if(h->less(b, a))
+	{
+		tmp = a;
+		a = b;
+		b = tmp;
+	}
+
+	/* b becomes the first child of a */
+	b->prev = a;
+	b->next = a->child;
+	if(a->child != NULL)
+		a->child->prev = b;
+	a->child = b;
+
+	return a;
+}
+
+/**
+ * Merge a list of siblings into a single heap, using the two-pass scheme that
+ * gives the amortized logarithmic bound
+ * \param[in] h The heap the items belong to (for comparison)
+ * \param[in] first First sibling
+ * \return Root of the merged heap
+ */
+static pheap_item *merge_siblings(pheap *h, pheap_item *first) RAMFUNC;
+static pheap_item *merge_siblings(pheap *h, pheap_item *first)
+{
+	pheap_item *a, *b, *pairs, *root;
+
+	/* Merge siblings by pairs from left to right, stacking the results */
+	pairs = NULL;
+	while(first != NULL)
+	{
+		a = first;
+		b = a->next;
+		first = (b != NULL) ? b->next : NULL;
+
+		a->next = NULL;
+		a->prev = NULL;
+		if(b != NULL)
+		{
+			b->next = NULL;
+			b->prev = NULL;
+		}
+
+		a = merge(h, a, b);
+		a->next = pairs;
+		pairs = a;
+	}
+
+	/* Merge the pairs from right to left */
+	root = NULL;
+	while(pairs != NULL)
+	{
+		a = pairs;
+		pairs = a->next;
+		a->next = NULL;
+
+		root = merge(h, root, a);
+	}
+
+	return root;
+}
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+void pheap_insert(pheap *h, pheap_item *item)
+{
+	item->child = NULL;
+	item->next = NULL;
+	item->prev = NULL;
+
+	h->root = merge(h, h->root, item);
+}
+
+pheap_item *pheap_pop(pheap *h)
+{
+	pheap_item *min;
+
+	min = h->root;
+	if(min == NULL)
+		return NULL;
+
+	h->root = merge_siblings(h, min->child);
+	min->child = NULL;
+
+	return min;
+}
+
+void pheap_remove(pheap *h, pheap_item *item)
+{
+	pheap_item *sub;
+
+	if(item == h->root)
+	{
+		pheap_pop(h);
+		return;
+	}
+
+	/* Detach the item with its subtree */
+	if(item->prev->child == item)
+		item->prev->child = item->next;
+	else
+		item->prev->next = item->next;
+
+	if(item->next != NULL)
+		item->next->prev = item->prev;
+
+	/* Put its children back in the heap */
+	sub = merge_siblings(h, item->child);
+	h->root = merge(h, h->root, sub);
+
+	item->child = NULL;
+	item->next = NULL;
+	item->prev = NULL;
+}
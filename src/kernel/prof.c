@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file prof.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Statistical profiler implementation
+ */
+#include <cpu/cpu_utils.h>
+#include <kernel/prof.h>
+#include <kernel/stdint.h>
+
+/* Linker-defined section symbols */
+extern uint32_t __text_end, __ramfunc_start, __ramfunc_end;
+
+/*******************************************************************************
+ * Private definitions
+ ******************************************************************************/
+/** Smallest bucket size, as a power of 2 (one Thumb instruction) */
+#define PROF_MIN_SHIFT (1)
+
+/** The profile data, dumped by the debugger */
+prof_data_t prof_data;
+
+/**
+ * Set up a code range with the smallest buckets that cover it
+ * \param[out] r The code range
+ * \param[in] start First address of the range
+ * \param[in] end Address following the range
+ * \param[in] first Index of the first bucket of the range
+ * \param[in] nb Number of buckets of the range
+ */
+static void setup_range(prof_range *r, void *start, void *end,
+                        uint32_t first, uint32_t nb)
+{
+	r->start = (uint32_t)(uintptr_t)start;
+	r->end = (uint32_t)(uintptr_t)end;
+	r->first = first;
+	r->nb = nb;
+
+	r->shift = PROF_MIN_SHIFT;
+	while(((r->end - r->start) >> r->shift) >= nb)
+		r->shift++;
+}
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+int prof_init(void)
+{
+	prof_data.version = PROF_VERSION;
+	prof_data.nb_ranges = PROF_NB_RANGES;
+	prof_data.nb_buckets = PROF_NB_BUCKETS;
+
+	setup_range(&prof_data.ranges[0], 0, &__text_end, 0,
+	            PROF_NB_FLASH_BUCKETS);
+	setup_range(&prof_data.ranges[1], &__ramfunc_start, &__ramfunc_end,
+	            PROF_NB_FLASH_BUCKETS, PROF_NB_RAM_BUCKETS);
+
+	prof_reset();
+
+	/* Start sampling */
+	prof_data.magic = PROF_MAGIC;
+
+	return 0;
+}
+
+void prof_reset(void)
+{
+	unsigned int i;
+
+	for(i = 0; i < PROF_NB_BUCKETS; i++)
+		prof_data.buckets[i] = 0;
+
+	prof_data.samples = 0;
+	prof_data.other = 0;
+}
+
+void prof_sample(uint32_t exc_return)
+{
+	cpu_ex_stack_frame *frame;
+	prof_range *r;
+	uint16_t *bucket;
+	uint32_t pc;
+	unsigned int i;
+
+	if(prof_data.magic != PROF_MAGIC)
+		return;
+
+	prof_data.samples++;
+
+	/*
+	 * Tasks run on the process stack, only the boot code waiting for the
+	 * first task switch runs on the main stack
+	 */
+	if(!(exc_return & CPU_EXC_RETURN_PSP))
+	{
+		prof_data.other++;
+		return;
+	}
+
+	frame = CPU_GET_PSP();
+	pc = frame->pc;
+
+	for(i = 0; i < PROF_NB_RANGES; i++)
+	{
+		r = &prof_data.ranges[i];
+
+		if((pc >= r->start) && (pc < r->end))
+		{
+			i = r->first + ((pc - r->start) >> r->shift);
+			bucket = &prof_data.buckets[i];
+			if(*bucket != UINT16_MAX)
+				(*bucket)++;
+			return;
+		}
+	}
+
+	prof_data.other++;
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file protect.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Kernel memory protection policy
+ */
+#include <cpu/cpu_mapping.h>
+#include <cpu/cpu_mpu.h>
+#include <cpu/cpu_scb.h>
+#include <kernel/errno.h>
+#include <kernel/protect.h>
+
+/*******************************************************************************
+ * Private definitions
+ ******************************************************************************/
+/** Size of each background region (code, SRAM and peripheral areas) */
+#define PROTECT_BACKGROUND_SIZE (0x20000000U)
+
+/** True if memory protection is enabled */
+static int enabled = 0;
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+int protect_init(void)
+{
+	/* Parts without an MPU read 0 regions */
+	if(mpu_get_nb_regions() < PROTECT_NB_REGIONS)
+	{
+		return ENODEV;
+	}
+
+	mpu_region_setup(PROTECT_REGION_FLASH, (void *)CPU_ROM_START,
+	                 PROTECT_BACKGROUND_SIZE,
+	                 MPU_ATTR_AP_RW | MPU_ATTR_FLASH);
+	mpu_region_setup(PROTECT_REGION_SRAM, (void *)CPU_SRAM_START,
+	                 PROTECT_BACKGROUND_SIZE,
+	                 MPU_ATTR_AP_RW | MPU_ATTR_SRAM);
+	mpu_region_setup(PROTECT_REGION_PERIPH, (void *)CPU_PERIPH_START,
+	                 PROTECT_BACKGROUND_SIZE,
+	                 MPU_ATTR_AP_RW | MPU_ATTR_XN | MPU_ATTR_DEVICE);
+
+	/* Report violations through the memory management fault handler */
+	scb_set_mem_manage_fault(1);
+	mpu_enable();
+	enabled = 1;
+
+	return 0;
+}
+
+int protect_is_enabled(void)
+{
+	return enabled;
+}
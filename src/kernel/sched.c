@@ -29,16 +29,79 @@
  * \author Maxime Bernelas <maxime@bernelas.fr>
  * Task management and scheduling routines
  */
+#include <cpu/cpu_mpu.h>
 #include <cpu/cpu_scb.h>
 #include <cpu/cpu_task.h>
 #include <cpu/cpu_utils.h>
+#include <kernel/clock.h>
+#include <kernel/grant.h>
 #include <kernel/kalloc.h>
+#include <kernel/kdata.h>
 #include <kernel/list.h>
+#include <kernel/pheap.h>
+#include <kernel/protect.h>
 #include <kernel/sched.h>
+#include <kernel/errno.h>
+#include <kernel/stdint.h>
+#include <kernel/string.h>
+#include <kernel/syscall.h>
+#include <kernel/trace.h>
 
 /*******************************************************************************
  * Private definitions
  ******************************************************************************/
+/** Size of the no-access region placed below each task stack */
+#ifdef CONFIG_STACK_GUARD_SIZE
+#define SCHED_STACK_GUARD_SIZE (CONFIG_STACK_GUARD_SIZE)
+#else
+#define SCHED_STACK_GUARD_SIZE (MPU_MIN_REGION_SIZE)
+#endif
+
+#if (SCHED_STACK_GUARD_SIZE < MPU_MIN_REGION_SIZE) ||                          \
+    (SCHED_STACK_GUARD_SIZE & (SCHED_STACK_GUARD_SIZE - 1))
+#error "STACK_GUARD_SIZE must be a power of 2 of at least 32 bytes"
+#endif
+
+/** Attributes of the stack guard region */
+#define SCHED_STACK_GUARD_ATTR (MPU_ATTR_AP_NONE | MPU_ATTR_XN | MPU_ATTR_SRAM)
+
+/** Stack pointer alignment required by the procedure call standard */
+#define SCHED_STACK_ALIGN (8)
+
+/** Round a pointer down to a multiple of a (power of 2) */
+#define SCHED_ALIGN_DOWN(p, a)                                                 \
+	((char *)((uintptr_t)(p) & ~(uintptr_t)((a) - 1)))
+
+/** Round a pointer up to a multiple of a (power of 2) */
+#define SCHED_ALIGN_UP(p, a) SCHED_ALIGN_DOWN(((char *)(p)) + (a) - 1, a)
+
+/** Length of the CPU load window in ticks */
+#define SCHED_LOAD_WINDOW (100)
+
+/**
+ * Number of sub-windows of the CPU load window. The window slides by one
+ * sub-window at a time, each costs a word per task.
+ */
+#define SCHED_LOAD_SLOTS (10)
+
+/** Length of a sub-window of the CPU load window in ticks */
+#define SCHED_LOAD_SLOT_TICKS (SCHED_LOAD_WINDOW / SCHED_LOAD_SLOTS)
+
+/** CPU load of a fully busy task or CPU, in permille */
+#define SCHED_LOAD_MAX (1000)
+
+/** Stack size of the idle task in bytes */
+#define SCHED_IDLE_STACK_SIZE (256)
+
+/** Byte painted on task stacks at creation, to find how deep they grow */
+#define SCHED_STACK_FILL (0xA5)
+
+/** Stack word still holding the painted pattern */
+#define SCHED_STACK_PATTERN (0xA5A5A5A5)
+
+/** Number of stack words checked on each tick that finds the CPU idle */
+#define SCHED_STACK_SCAN_WORDS (32)
+
 /** Task states */
 typedef enum
 {
@@ -48,18 +111,93 @@ typedef enum
 	TASK_DEAD        /**< Task terminated */
 } task_state;
 
+/**
+ * Scheduling class, the operations of a scheduling policy. The classes are
+ * asked in turn for a task to run, so tasks of a class run only when no task
+ * of the previous classes is ready. Operations are called with irqs disabled.
+ */
+typedef struct
+{
+	/**
+	 * Add a task that became ready to the run queue of the class
+	 * \param[in,out] t The task
+	 */
+	void (*enqueue)(task_t *t);
+
+	/**
+	 * Remove a task no longer ready from the run queue of the class. Tasks
+	 * stay in the run queue while running.
+	 * \param[in,out] t The task
+	 */
+	void (*dequeue)(task_t *t);
+
+	/**
+	 * Choose the task of the class to run next
+	 * \param[in] curr The current task if it is of this class and still
+	 * running, NULL otherwise
+	 * \return The task to run, NULL if the class has no ready task
+	 */
+	task_t *(*pick_next)(task_t *curr);
+
+	/**
+	 * Account a tick to the running task of the class
+	 * \param[in,out] t The running task
+	 * \return True if the task must be preempted, false otherwise
+	 */
+	int (*tick)(task_t *t);
+
+	/**
+	 * Handle the running task of the class giving up the CPU
+	 * \param[in,out] t The running task, still ready
+	 */
+	void (*yield)(task_t *t);
+
+	/**
+	 * Handle the running task of the class being switched out while it
+	 * did not give up the CPU
+	 * \param[in,out] t The preempted task, still ready
+	 */
+	void (*preempt)(task_t *t);
+} sched_class;
+
 /** Task structure */
 struct _task
 {
 	void *sp;             /**< Stack pointer */
+	void *mem;            /**< Allocated block holding the task and its
+	                           stack */
 	task_state state;     /**< State */
 	list_item list;       /**< Task list item */
+	const sched_class *class; /**< Scheduling class */
+	list_item run;        /**< Run queue item, while ready or running */
+	list_item preempted;  /**< Item in the stack of preempted tasks */
 	unsigned char priv;   /**< True if task is privileged */
-	unsigned char pad[3]; /**< Padding bytes (will be used as canary) */
+	char *guard;          /**< Stack guard address, NULL if none */
+	mpu_region_t guard_region; /**< Stack guard MPU region values */
+	uint32_t *stack_base; /**< Lowest word of the stack */
+	uint32_t *stack_top;  /**< End of the stack */
+	uint32_t *stack_mark; /**< Lowest stack word found overwritten */
+	uint32_t quantum;     /**< Number of ticks the task runs when elected */
+	uint32_t quantum_left; /**< Ticks left in the current quantum */
+	uint8_t priority;     /**< Priority, 0 is the lowest */
+	uint8_t threshold;    /**< Priority a task must exceed to preempt it */
+	pheap_item timer;     /**< Sleep queue item */
+	uint64_t wake_tick;   /**< Tick at which a sleeping task is woken up */
+	unsigned char timed;  /**< True while in the sleep queue */
+	uint64_t run_cycles;  /**< Cycles spent running since creation */
+	uint32_t window_cycles; /**< Cycles spent running in the load window */
+	uint32_t slot_cycles[SCHED_LOAD_SLOTS]; /**< Same, per sub-window */
+	uint32_t switches;    /**< Number of times the task was switched in */
+	uint32_t load;        /**< CPU share over the last window, permille */
+#ifdef CONFIG_SCHED_LATENCY
+	uint32_t ready_stamp; /**< Timestamp of the last wakeup */
+	unsigned char ready_pending; /**< True until a wakeup is dispatched */
+	sched_latency_stats latency; /**< Wakeup to dispatch latency */
+#endif
 };
 
-/** List of tasks */
-static list_item *task_list = NULL;
+/** List of tasks, except the idle task */
+static list_item task_list = LIST_INIT(task_list);
 
 /** Current task pointer */
 static task_t *current_task = NULL;
@@ -67,6 +205,119 @@ static task_t *current_task = NULL;
 /** Idle task pointer */
 static task_t *idle_task = NULL;
 
+/** True if tasks stacks are protected by an MPU guard region */
+static int stack_guards = 0;
+
+/** Task whose stack is being scanned on idle ticks */
+static task_t *scan_task = NULL;
+
+/** Next stack word of scan_task to check */
+static uint32_t *scan_pos;
+
+/**
+ * Compare the wakeup ticks of two sleeping tasks
+ * \param[in] a Sleep queue item of the first task
+ * \param[in] b Sleep queue item of the second task
+ * \return True if a wakes up before b, false otherwise
+ */
+static int wakes_before(const pheap_item *a, const pheap_item *b) RAMFUNC;
+
+/** Tasks sleeping for a time, by wakeup tick */
+static pheap sleep_queue = PHEAP_INIT(wakes_before);
+
+static void tt_enqueue(task_t *t) RAMFUNC;
+static void tt_dequeue(task_t *t) RAMFUNC;
+static task_t *tt_pick_next(task_t *curr) RAMFUNC;
+static int tt_tick(task_t *t) RAMFUNC;
+static void tt_yield(task_t *t) RAMFUNC;
+static void tt_preempt(task_t *t) RAMFUNC;
+
+/**
+ * Time-triggered class: its tasks run as soon as they are ready, in the order
+ * they became ready, until they sleep. Ticks never preempt them.
+ */
+static const sched_class tt_class =
+{
+	tt_enqueue,
+	tt_dequeue,
+	tt_pick_next,
+	tt_tick,
+	tt_yield,
+	tt_preempt
+};
+
+/** Ready and running tasks of the time-triggered class */
+static list_item tt_queue = LIST_INIT(tt_queue);
+
+static void rr_enqueue(task_t *t) RAMFUNC;
+static void rr_dequeue(task_t *t) RAMFUNC;
+static task_t *rr_pick_next(task_t *curr) RAMFUNC;
+static int rr_tick(task_t *t) RAMFUNC;
+static void rr_yield(task_t *t) RAMFUNC;
+static void rr_preempt(task_t *t) RAMFUNC;
+
+/**
+ * Fixed-priority round-robin class: the first ready task with the highest
+ * priority runs for its quantum, then goes to the end of the run queue. The
+ * running task is only preempted by tasks with a priority above its threshold.
+ * A preempted task resumes its quantum with its threshold still in force:
+ * until it runs again, other tasks need a priority above the thresholds of all
+ * the preempted tasks to be elected.
+ */
+static const sched_class rr_class =
+{
+	rr_enqueue,
+	rr_dequeue,
+	rr_pick_next,
+	rr_tick,
+	rr_yield,
+	rr_preempt
+};
+
+/** Ready and running tasks of the round-robin class */
+static list_item rr_queue = LIST_INIT(rr_queue);
+
+/** Preempted tasks of the round-robin class, the latest first */
+static list_item rr_preempted = LIST_INIT(rr_preempted);
+
+static void idle_nop(task_t *t) RAMFUNC;
+static task_t *idle_pick_next(task_t *curr) RAMFUNC;
+static int idle_tick(task_t *t) RAMFUNC;
+
+/** Idle class, holding the idle task alone, which is always ready */
+static const sched_class idle_class =
+{
+	idle_nop,
+	idle_nop,
+	idle_pick_next,
+	idle_tick,
+	idle_nop,
+	idle_nop
+};
+
+/** Scheduling classes, in election order */
+static const sched_class *const sched_classes[] =
+{
+	&tt_class,
+	&rr_class,
+	&idle_class
+};
+
+/** Number of scheduling classes */
+#define SCHED_NB_CLASSES (sizeof(sched_classes) / sizeof(sched_classes[0]))
+
+/** Cycle count when the current task was switched in */
+static uint32_t slice_start;
+
+/** Number of ticks elapsed in the current load sub-window */
+static unsigned int window_ticks;
+
+/** Index of the current load sub-window */
+static unsigned int window_slot;
+
+/** CPU load over the last window in permille */
+static uint32_t cpu_load;
+
 /*******************************************************************************
  * Private functions
  ******************************************************************************/
@@ -74,43 +325,380 @@ static task_t *idle_task = NULL;
  * Elect next task for scheduling
  * \return Handler of the elected task
  */
+static task_t * sched_elect(void) RAMFUNC;
 static task_t * sched_elect(void)
 {
-	list_item *tmp;
+	const sched_class *class;
+	task_t *curr = NULL;
+	task_t *t;
+	unsigned int i;
+
+	/* Current task may keep running if it did not give up the CPU */
+	if(current_task && (current_task->state == TASK_RUNNING))
+		curr = current_task;
+
+	/* First class with a task to run wins */
+	for(i = 0; i < SCHED_NB_CLASSES; i++)
+	{
+		class = sched_classes[i];
+		t = class->pick_next((curr && (curr->class == class)) ? curr :
+		                                                          NULL);
+		if(t)
+			return t;
+	}
+
+	/* The idle class always has a task to run */
+	return idle_task;
+}
+
+static void tt_enqueue(task_t *t)
+{
+	list_add_tail(&tt_queue, &t->run);
+}
+
+static void tt_dequeue(task_t *t)
+{
+	list_remove(&t->run);
+}
+
+static task_t *tt_pick_next(task_t *curr)
+{
+	list_item *first;
+
+	if(curr)
+		return curr;
+
+	first = list_first(&tt_queue);
+
+	return first ? LIST_GET_OBJECT(first, task_t, run) : NULL;
+}
+
+static int tt_tick(task_t *t)
+{
+	(void)t;
+
+	return 0;
+}
+
+static void tt_yield(task_t *t)
+{
+	/* Go after the other ready tasks of the class */
+	list_remove(&t->run);
+	list_add_tail(&tt_queue, &t->run);
+}
+
+static void tt_preempt(task_t *t)
+{
+	/* No class comes first, only a terminating task switches it out */
+	(void)t;
+}
+
+static void rr_enqueue(task_t *t)
+{
+	t->quantum_left = t->quantum;
+	list_add_tail(&rr_queue, &t->run);
+}
+
+static void rr_dequeue(task_t *t)
+{
+	list_remove(&t->run);
+	list_remove(&t->preempted);
+}
+
+static task_t *rr_pick_next(task_t *curr)
+{
+	task_t *t, *best = NULL, *resume;
+	list_item *first;
+	uint8_t ceiling;
+
+	/* Elect first task in the queue with the highest priority */
+	LIST_FOR_EACH_OBJECT(t, &rr_queue, task_t, run)
+	{
+		if((best == NULL) || (t->priority > best->priority))
+			best = t;
+	}
+
+	if(best == NULL)
+		return NULL;
+
+	/*
+	 * Current task runs until its quantum is over or it gives up the CPU,
+	 * and the latest preempted task resumes first, unless a task with a
+	 * priority above their thresholds is ready
+	 */
+	first = list_first(&rr_preempted);
+	resume = curr;
+	if((resume == NULL) && first)
+		resume = LIST_GET_OBJECT(first, task_t, preempted);
+	if(resume == NULL)
+		return best;
+
+	ceiling = resume->threshold;
+	LIST_FOR_EACH_OBJECT(t, &rr_preempted, task_t, preempted)
+	{
+		if(t->threshold > ceiling)
+			ceiling = t->threshold;
+	}
+
+	if(best->priority <= ceiling)
+		best = resume;
+
+	/* The elected task runs, its threshold is the running one again */
+	list_remove(&best->preempted);
+
+	return best;
+}
+
+static int rr_tick(task_t *t)
+{
+	if(t->quantum_left <= 1)
+		return 1;
+
+	t->quantum_left--;
+
+	return 0;
+}
+
+static void rr_yield(task_t *t)
+{
+	/* Go after the tasks of equal priority, with a new quantum */
+	list_remove(&t->run);
+	rr_enqueue(t);
+}
+
+static void rr_preempt(task_t *t)
+{
+	/* Keep its threshold in force until it runs again */
+	list_add_head(&rr_preempted, &t->preempted);
+}
+
+static void idle_nop(task_t *t)
+{
+	(void)t;
+}
+
+static task_t *idle_pick_next(task_t *curr)
+{
+	(void)curr;
+
+	return idle_task;
+}
+
+static int idle_tick(task_t *t)
+{
+	/* Tasks becoming ready request a switch, no need to check on ticks */
+	(void)t;
+
+	return 0;
+}
+
+static int wakes_before(const pheap_item *a, const pheap_item *b)
+{
+	return (PHEAP_GET_OBJECT(a, task_t, timer)->wake_tick <
+	        PHEAP_GET_OBJECT(b, task_t, timer)->wake_tick);
+}
+
+/**
+ * Choose the wakeup tick of a timed sleep in its slack window. The tick with
+ * the most trailing zero bits is taken, so that tasks with overlapping windows
+ * agree on the same tick and get woken up together.
+ * \param[in] earliest Earliest tick allowed
+ * \param[in] slack Number of ticks the wakeup may be delayed by
+ * \return The wakeup tick
+ */
+static uint64_t slack_wake_tick(uint64_t earliest, uint32_t slack)
+{
+	uint64_t latest, diff, mask;
+
+	latest = earliest + slack;
+	diff = earliest ^ latest;
+	if(diff == 0)
+		return earliest;
+
+	/* Clear bits of latest below the highest bit that differs */
+	mask = 1;
+	while(diff >>= 1)
+		mask <<= 1;
+
+	return (latest & ~(mask - 1));
+}
+
+/** Charge the time elapsed since it was switched in to the current task */
+static void account_current(void) RAMFUNC;
+static void account_current(void)
+{
+	uint32_t now, delta;
+
+	now = clock_get_timestamp();
+	delta = now - slice_start;
+	slice_start = now;
+
+	if(current_task)
+	{
+		current_task->run_cycles += delta;
+		current_task->window_cycles += delta;
+		current_task->slot_cycles[window_slot] += delta;
+	}
+}
+
+/**
+ * Compute the load of a task over the load window, and drop its oldest
+ * sub-window from it
+ * \param[in,out] t The task
+ * \param[in] unit Number of cycles in a permille of the window
+ * \param[in] next Index of the sub-window to start
+ */
+static void close_window(task_t *t, uint32_t unit, unsigned int next)
+{
+	t->load = t->window_cycles / unit;
+	if(t->load > SCHED_LOAD_MAX)
+		t->load = SCHED_LOAD_MAX;
+
+	t->window_cycles -= t->slot_cycles[next];
+	t->slot_cycles[next] = 0;
+}
+
+/**
+ * End a CPU load sub-window, computing the load of every task over the last
+ * SCHED_LOAD_WINDOW ticks, and slide the window
+ */
+static void end_load_window(void)
+{
 	task_t *t;
+	uint32_t total, unit;
+	unsigned int next;
 
-	/* No current task, elect idle task */
-	if(current_task == NULL)
-		return idle_task;
+	account_current();
 
-	/* Place current task at the end of the list */
-	list_remove(&task_list, &current_task->list);
-	list_add_tail(&task_list, &current_task->list);
+	total = idle_task->window_cycles;
+	LIST_FOR_EACH_OBJECT(t, &task_list, task_t, list)
+	{
+		total += t->window_cycles;
+	}
+
+	unit = total / SCHED_LOAD_MAX;
+	if(unit == 0)
+		unit = 1;
 
-	/* Elect first ready task in the list (round-robin scheduling) */
-	tmp = task_list;
-	while(tmp)
+	next = (window_slot + 1) % SCHED_LOAD_SLOTS;
+	close_window(idle_task, unit, next);
+	LIST_FOR_EACH_OBJECT(t, &task_list, task_t, list)
 	{
-		t = LIST_GET_OBJECT(tmp, task_t, list);
+		close_window(t, unit, next);
+	}
+	window_slot = next;
+
+	cpu_load = SCHED_LOAD_MAX - idle_task->load;
+	kdata_set_load(cpu_load);
+}
+
+/**
+ * Make a sleeping task ready
+ * \param[in,out] t The task
+ */
+static void make_ready(task_t *t) RAMFUNC;
+static void make_ready(task_t *t)
+{
+	t->state = TASK_READY;
+	t->class->enqueue(t);
+
+#ifdef CONFIG_SCHED_LATENCY
+	t->ready_stamp = clock_get_timestamp();
+	t->ready_pending = 1;
+#endif
+}
+
+#ifdef CONFIG_SCHED_LATENCY
+/**
+ * Record the latency between the wakeup of a task and its dispatch
+ * \param[in,out] t The task being dispatched
+ */
+static void record_latency(task_t *t) RAMFUNC;
+static void record_latency(task_t *t)
+{
+	uint32_t cycles;
+	unsigned int bucket;
+
+	if(!t->ready_pending)
+		return;
+
+	t->ready_pending = 0;
+	cycles = clock_get_timestamp() - t->ready_stamp;
+
+	t->latency.count++;
+	if(cycles > t->latency.max_cycles)
+		t->latency.max_cycles = cycles;
+
+	/* Bucket n holds latencies in [2^n, 2^(n+1)), the last one the rest */
+	bucket = (cycles == 0) ? 0 : (31 - __builtin_clz(cycles));
+	if(bucket >= SCHED_LATENCY_NB_BUCKETS)
+		bucket = SCHED_LATENCY_NB_BUCKETS - 1;
+	if(t->latency.histogram[bucket] != UINT16_MAX)
+		t->latency.histogram[bucket]++;
+}
+#endif
 
-		if(t->state == TASK_READY)
+/**
+ * Scan the stack of a task from the bottom for the first overwritten word,
+ * and lower the stack mark of the task to it. Irqs must be disabled.
+ * \param[in,out] t The task
+ * \param[in] from First word to check
+ * \param[in] max Maximum number of words to check
+ * \return The next word to check, NULL if the scan reached the stack mark
+ */
+static uint32_t *stack_scan(task_t *t, uint32_t *from, size_t max)
+{
+	uint32_t *p;
+
+	for(p = from; (p < t->stack_mark) && (max > 0); p++, max--)
+	{
+		if(*p != SCHED_STACK_PATTERN)
 		{
-			return t;
+			t->stack_mark = p;
+			return NULL;
 		}
+	}
+
+	return (p < t->stack_mark) ? p : NULL;
+}
+
+/**
+ * Check a few more stack words of the tasks, in turn, so that stack marks stay
+ * up to date without any request. Called by the tick handler when it
+ * interrupts the idle task: the idle task is unprivileged and cannot mask
+ * irqs, while in the handler schedule() cannot release the scanned task.
+ */
+static void stack_scan_step(void)
+{
+	list_item *next;
 
-		tmp = tmp->next;
+	/* Restart from the idle task, also after the scanned task exited */
+	if(scan_task == NULL)
+	{
+		scan_task = idle_task;
+		scan_pos = scan_task->stack_base;
 	}
 
-	/* No task ready, elect idle task */
-	return idle_task;
+	scan_pos = stack_scan(scan_task, scan_pos, SCHED_STACK_SCAN_WORDS);
+	if(scan_pos == NULL)
+	{
+		/* Go on with the next task, then back to the idle task */
+		next = (scan_task == idle_task) ? task_list.next :
+		                                  scan_task->list.next;
+		if(next == &task_list)
+			scan_task = idle_task;
+		else
+			scan_task = LIST_GET_OBJECT(next, task_t, list);
+
+		scan_pos = scan_task->stack_base;
+	}
 }
 
-/** Task termination routine */
+/** Task termination routine, called when the task routine returns */
 static void task_exit(void)
 {
-	current_task->state = TASK_DEAD;
-
-	scb_set_pendSV();
+	/* Unprivileged tasks can neither mask IRQs nor request a switch */
+	__do_svc(0, 0, 0, 0, SYSCALL_TASK_EXIT);
 
 	/* Wait until scheduler executes and removes this task */
 	while(1)
@@ -134,63 +722,288 @@ static void idle(void *arg)
  * Public functions
  ******************************************************************************/
 task_t *sched_create_task(void (*f)(void *), void *arg, size_t stack_size,
-                          unsigned char priv)
+                          unsigned char priv, uint32_t quantum)
 {
 	task_t *t;
+	char *mem, *stack, *guard;
+	size_t guard_size;
+	int flags;
+
+	/*
+	 * Reserve room for the guard region below the stack, plus its alignment
+	 * constraint
+	 */
+	guard_size = stack_guards ? (2 * SCHED_STACK_GUARD_SIZE) : 0;
 
 	/*
 	 * Allocate task struct and stack at the same time to avoid allocation
-	 * overhead
+	 * overhead. The task struct goes above the stack, where an overflow
+	 * cannot reach it.
 	 */
-	t = kmalloc(sizeof(*t) + stack_size);
-	if(t == NULL)
+	mem = kmalloc(guard_size + stack_size + SCHED_STACK_ALIGN + sizeof(*t));
+	if(mem == NULL)
 		return NULL;
 
-	/* TODO: should make sure stack pointer is correctly aligned */
-	t->sp = ((unsigned char *)t) + sizeof(*t) + stack_size;
+	stack = mem;
+	guard = NULL;
+
+	if(stack_guards)
+	{
+		/* Guard region base address must be aligned on its size */
+		guard = SCHED_ALIGN_UP(stack, SCHED_STACK_GUARD_SIZE);
+		stack = guard + SCHED_STACK_GUARD_SIZE;
+	}
+
+	t = (task_t *)SCHED_ALIGN_UP(stack + stack_size, SCHED_STACK_ALIGN);
+	t->mem = mem;
+	t->guard = guard;
+	if(guard)
+	{
+		mpu_region_compute(PROTECT_REGION_STACK_GUARD, guard,
+		                   SCHED_STACK_GUARD_SIZE,
+		                   SCHED_STACK_GUARD_ATTR, &t->guard_region);
+	}
+
+	t->sp = SCHED_ALIGN_DOWN(stack + stack_size, SCHED_STACK_ALIGN);
+
+	/* Paint the stack, words still painted were never used */
+	t->stack_base = (uint32_t *)SCHED_ALIGN_UP(stack, sizeof(uint32_t));
+	t->stack_top = t->sp;
+	t->stack_mark = t->stack_top;
+	memset(t->stack_base, SCHED_STACK_FILL,
+	       (char *)t->stack_top - (char *)t->stack_base);
+
 	t->state = TASK_READY;
 	t->priv = priv;
-	t->list.next = NULL;
-	t->list.prev = NULL;
-
-#ifdef DEBUG
-	/* Setup canary to help spot stack overflow in task */
-	t->pad[0] = 0xA5;
-	t->pad[1] = 0xA5;
-	t->pad[2] = 0xA5;
+	t->quantum = quantum ? quantum : SCHED_DEFAULT_QUANTUM;
+	t->priority = 0;
+	t->threshold = 0;
+	list_init(&t->preempted);
+	t->run_cycles = 0;
+	t->window_cycles = 0;
+	memset(t->slot_cycles, 0x00, sizeof(t->slot_cycles));
+	t->switches = 0;
+	t->load = 0;
+	t->timed = 0;
+#ifdef CONFIG_SCHED_LATENCY
+	t->ready_pending = 0;
+	memset(&t->latency, 0x00, sizeof(t->latency));
 #endif
 
 	/* Create task context */
 	t->sp = cpu_task_create_context(t->sp, (void *)f, arg, task_exit);
+	if(t->sp == NULL)
+	{
+		kfree(mem);
+		return NULL;
+	}
 
+	/* Tasks start in the round-robin class */
+	flags = cpu_irq_disable();
 	list_add_tail(&task_list, &t->list);
+	t->class = &rr_class;
+	t->class->enqueue(t);
+
+	/* Elect again, the new task may be above the running one */
+	if(current_task)
+		scb_set_pendSV();
+
+	cpu_irq_restore(flags);
 
 	return t;
 }
 
 void sched_sleep(void)
 {
+	int flags;
+
+	flags = cpu_irq_disable();
+
 	if(current_task)
+	{
 		current_task->state = TASK_SLEEPING;
+		current_task->class->dequeue(current_task);
+	}
 	scb_set_pendSV();
+
+	cpu_irq_restore(flags);
 }
 
-void sched_yield(void)
+int sched_sleep_ticks(uint32_t ticks, uint32_t slack)
+{
+	int flags;
+
+	if((ticks == 0) || (current_task == NULL))
+		return EINVAL;
+
+	flags = cpu_irq_disable();
+
+	/*
+	 * The current tick is partly over, wait for one more so that the task
+	 * sleeps for at least the requested number of tick periods
+	 */
+	current_task->wake_tick = slack_wake_tick(clock_get_ticks() + ticks + 1,
+	                                          slack);
+	pheap_insert(&sleep_queue, &current_task->timer);
+	current_task->timed = 1;
+	current_task->state = TASK_SLEEPING;
+	current_task->class->dequeue(current_task);
+	scb_set_pendSV();
+
+	cpu_irq_restore(flags);
+
+	return 0;
+}
+
+int sched_wakeup(task_t *t)
+{
+	int flags;
+
+	if(t == NULL)
+		return EINVAL;
+
+	flags = cpu_irq_disable();
+
+	if(t->state == TASK_SLEEPING)
+	{
+		/* Cancel the timeout of a timed sleep */
+		if(t->timed)
+		{
+			pheap_remove(&sleep_queue, &t->timer);
+			t->timed = 0;
+		}
+
+		make_ready(t);
+		scb_set_pendSV();
+	}
+
+	cpu_irq_restore(flags);
+
+	return 0;
+}
+
+int sched_set_priority(task_t *t, uint8_t priority, uint8_t threshold)
+{
+	int flags;
+
+	if((t == NULL) || (threshold < priority))
+		return EINVAL;
+
+	flags = cpu_irq_disable();
+
+	t->priority = priority;
+	t->threshold = threshold;
+
+	/* Election may change, let the scheduler check */
+	if(current_task)
+		scb_set_pendSV();
+
+	cpu_irq_restore(flags);
+
+	return 0;
+}
+
+int sched_set_time_triggered(task_t *t)
 {
+	int flags;
+
+	if(t == NULL)
+		return EINVAL;
+
+	flags = cpu_irq_disable();
+
+	/* Move the task to the run queue of its new class, if it is in one */
+	if((t->state == TASK_READY) || (t->state == TASK_RUNNING))
+	{
+		t->class->dequeue(t);
+		t->class = &tt_class;
+		t->class->enqueue(t);
+	}
+	else
+	{
+		t->class = &tt_class;
+	}
+
 	if(current_task)
+		scb_set_pendSV();
+
+	cpu_irq_restore(flags);
+
+	return 0;
+}
+
+void sched_yield(void)
+{
+	int flags;
+
+	flags = cpu_irq_disable();
+
+	/* A task that is going to sleep must not be made ready again */
+	if(current_task && (current_task->state == TASK_RUNNING))
+	{
 		current_task->state = TASK_READY;
+		current_task->class->yield(current_task);
+	}
 	scb_set_pendSV();
+
+	cpu_irq_restore(flags);
+}
+
+void sched_tick(void)
+{
+	task_t *t;
+	uint64_t now;
+	int woken = 0;
+
+	now = clock_get_ticks();
+
+	/* Wake up every expired sleeper, they are all elected in one pass */
+	while(!pheap_is_empty(&sleep_queue))
+	{
+		t = PHEAP_GET_OBJECT(pheap_peek(&sleep_queue), task_t, timer);
+		if(t->wake_tick > now)
+			break;
+
+		pheap_pop(&sleep_queue);
+		t->timed = 0;
+		make_ready(t);
+		woken = 1;
+	}
+
+	/* Woken tasks may preempt the current one */
+	if(woken)
+		scb_set_pendSV();
+
+	if(++window_ticks >= SCHED_LOAD_SLOT_TICKS)
+	{
+		window_ticks = 0;
+		end_load_window();
+	}
+
+	/* Spend idle time refreshing the stack marks */
+	if(current_task == idle_task)
+		stack_scan_step();
+
+	/* Let the class of the current task decide on preemption */
+	if(current_task && (current_task->state == TASK_RUNNING) &&
+	   current_task->class->tick(current_task))
+		sched_yield();
 }
 
 int sched_init(void)
 {
+	/* Use stack guards if memory protection is available */
+	stack_guards = protect_is_enabled();
+
 	/* Create idle task */
-	idle_task = sched_create_task(idle, NULL, 128, 0);
+	idle_task = sched_create_task(idle, NULL, SCHED_IDLE_STACK_SIZE, 0, 0);
 	if(idle_task == NULL)
 		return 1;
 
-	/* Remove idle task from task list */
-	list_remove(&task_list, &idle_task->list);
+	/* Remove idle task from task list, it has a class of its own */
+	list_remove(&idle_task->list);
+	idle_task->class->dequeue(idle_task);
+	idle_task->class = &idle_class;
 
 	return 0;
 }
@@ -201,14 +1014,38 @@ void schedule(void)
 
 	next = sched_elect();
 
+	/* A preempted task stays in its run queue */
+	if(current_task && (next != current_task) &&
+	   (current_task->state == TASK_RUNNING))
+	{
+		current_task->state = TASK_READY;
+		current_task->class->preempt(current_task);
+	}
+
+	account_current();
+#ifdef CONFIG_SCHED_LATENCY
+	record_latency(next);
+#endif
+	if(next != current_task)
+	{
+		next->switches++;
+		TRACE(TRACE_SWITCH,
+		      current_task ? current_task->state : TASK_DEAD, next);
+	}
+
 	/* current_task my be NULL on the very first context switch */
 	if(current_task)
 	{
 		/* Check if current task has terminated */
 		if(current_task->state == TASK_DEAD)
 		{
-			list_remove(&task_list, &current_task->list);
-			kfree(current_task);
+			/* Task list changes, restart the idle stack scan */
+			if(scan_task == current_task)
+				scan_task = NULL;
+
+			list_remove(&current_task->list);
+			grant_release_task(current_task);
+			kfree(current_task->mem);
 		}
 		else
 		{
@@ -218,11 +1055,115 @@ void schedule(void)
 
 	current_task = next;
 	current_task->state = TASK_RUNNING;
+	kdata_set_current_task(current_task);
+
+	/* Move the guard region below the stack of the new task */
+	if(stack_guards)
+		mpu_region_load(&current_task->guard_region);
+
+	/* Give access to the buffers lent to the new task */
+	grant_switch(current_task);
 
 	CPU_SET_PSP(current_task->sp);
 }
 
+void sched_do_exit(void)
+{
+	int flags;
+
+	flags = cpu_irq_disable();
+	current_task->state = TASK_DEAD;
+	current_task->class->dequeue(current_task);
+	scb_set_pendSV();
+	cpu_irq_restore(flags);
+}
+
 int sched_is_task_privileged(void)
 {
 	return (current_task->priv);
 }
+
+task_t *sched_get_current_task(void)
+{
+	return current_task;
+}
+
+int sched_get_task_stats(task_t *t, sched_task_stats *stats)
+{
+	int flags;
+
+	if(stats == NULL)
+		return EINVAL;
+
+	if(t == NULL)
+		t = idle_task;
+
+	flags = cpu_irq_disable();
+
+	/* Include the time the task has been running for, if it is running */
+	if(t == current_task)
+		account_current();
+
+	stats->run_cycles = t->run_cycles;
+	stats->switches = t->switches;
+	stats->load = t->load;
+
+	cpu_irq_restore(flags);
+
+	return 0;
+}
+
+int sched_get_latency_stats(task_t *t, sched_latency_stats *stats)
+{
+#ifdef CONFIG_SCHED_LATENCY
+	int flags;
+
+	if((t == NULL) || (stats == NULL))
+		return EINVAL;
+
+	flags = cpu_irq_disable();
+	*stats = t->latency;
+	cpu_irq_restore(flags);
+
+	return 0;
+#else
+	(void)t;
+	(void)stats;
+
+	return ENOTSUP;
+#endif
+}
+
+unsigned int sched_get_cpu_load(void)
+{
+	return cpu_load;
+}
+
+int sched_is_stack_guard(task_t *t, void *addr)
+{
+	if((t == NULL) || (t->guard == NULL))
+		return 0;
+
+	return (((char *)addr >= t->guard) &&
+	        ((char *)addr < t->guard + SCHED_STACK_GUARD_SIZE));
+}
+
+size_t sched_stack_high_water(task_t *t)
+{
+	uint32_t *p;
+	int flags;
+
+	if(t == NULL)
+		t = idle_task;
+
+	/* Scan by small steps, not to keep irqs disabled for long */
+	p = t->stack_base;
+	do
+	{
+		flags = cpu_irq_disable();
+		p = stack_scan(t, p, SCHED_STACK_SCAN_WORDS);
+		cpu_irq_restore(flags);
+	} while(p != NULL);
+
+	return (char *)t->stack_top - (char *)t->stack_mark;
+}
@@ -29,14 +29,84 @@
  * \author Maxime Bernelas <maxime@bernelas.fr>
  * String management functions
  */
+#include <cpu/cpu_string.h>
 #include <kernel/string.h>
 #include <kernel/stddef.h>
+#include <kernel/stdint.h>
 
+/*******************************************************************************
+ * Private definitions
+ ******************************************************************************/
+/** Machine word, which may alias any other type */
+typedef uint32_t __attribute__((may_alias)) word_t;
+
+/** Machine word at a possibly unaligned address */
+typedef struct
+{
+	word_t w;     /**< Word value */
+} __attribute__((packed, may_alias)) unaligned_word_t;
+
+/** Size of a machine word in bytes */
+#define WORD_SIZE (sizeof(word_t))
+
+/** Test if a pointer is word-aligned */
+#define IS_WORD_ALIGNED(p) ((((uintptr_t)(p)) & (WORD_SIZE - 1)) == 0)
+
+/**
+ * Below this size, aligning pointers costs more than it saves so everything is
+ * done bytewise
+ */
+#define SMALL_SIZE (2 * WORD_SIZE)
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
 void *memcpy(void *dest, const void *src, size_t n)
 {
 	unsigned char *d = dest;
 	const unsigned char *s = src;
+	size_t len;
+
+	if(n >= SMALL_SIZE)
+	{
+		/* Copy the head bytewise until destination is aligned */
+		while(!IS_WORD_ALIGNED(d))
+		{
+			*d++ = *s++;
+			n--;
+		}
+
+		if(IS_WORD_ALIGNED(s))
+		{
+			/* Both pointers aligned, move whole bursts */
+			len = n - (n % CPU_BURST_SIZE);
+			cpu_copy_burst(d, s, len);
+			d += len;
+			s += len;
+			n -= len;
 
+			while(n >= WORD_SIZE)
+			{
+				*(word_t *)d = *(const word_t *)s;
+				d += WORD_SIZE;
+				s += WORD_SIZE;
+				n -= WORD_SIZE;
+			}
+		}
+		else
+		{
+			/* The CPU handles unaligned single word loads */
+			while(n >= WORD_SIZE)
+			{
+				*(word_t *)d = ((const unaligned_word_t *)s)->w;
+				d += WORD_SIZE;
+				s += WORD_SIZE;
+				n -= WORD_SIZE;
+			}
+		}
+	}
+
+	/* Copy the tail */
 	while(n)
 	{
 		*d++ = *s++;
@@ -46,10 +116,101 @@ void *memcpy(void *dest, const void *src, size_t n)
 	return dest;
 }
 
+void *memmove(void *dest, const void *src, size_t n)
+{
+	unsigned char *d = dest;
+	const unsigned char *s = src;
+	size_t len;
+
+	/* A forward copy never overwrites source bytes before reading them */
+	if((d <= s) || (d >= s + n))
+	{
+		return memcpy(dest, src, n);
+	}
+
+	/* Overlapping areas with dest after src, copy from the end */
+	d += n;
+	s += n;
+
+	if(n >= SMALL_SIZE)
+	{
+		while(!IS_WORD_ALIGNED(d))
+		{
+			*--d = *--s;
+			n--;
+		}
+
+		if(IS_WORD_ALIGNED(s))
+		{
+			len = n - (n % CPU_BURST_SIZE);
+			cpu_copy_burst_backward(d, s, len);
+			d -= len;
+			s -= len;
+			n -= len;
+
+			while(n >= WORD_SIZE)
+			{
+				d -= WORD_SIZE;
+				s -= WORD_SIZE;
+				n -= WORD_SIZE;
+				*(word_t *)d = *(const word_t *)s;
+			}
+		}
+		else
+		{
+			while(n >= WORD_SIZE)
+			{
+				d -= WORD_SIZE;
+				s -= WORD_SIZE;
+				n -= WORD_SIZE;
+				*(word_t *)d = ((const unaligned_word_t *)s)->w;
+			}
+		}
+	}
+
+	while(n)
+	{
+		*--d = *--s;
+		n--;
+	}
+
+	return dest;
+}
+
 void *memset(void *dest, int val, size_t n)
 {
 	unsigned char *d = dest;
+	word_t w;
+	size_t len;
+
+	if(n >= SMALL_SIZE)
+	{
+		/* Fill the head bytewise until destination is aligned */
+		while(!IS_WORD_ALIGNED(d))
+		{
+			*d++ = val;
+			n--;
+		}
+
+		/* Replicate the byte value in a whole word */
+		w = (unsigned char)val;
+		w |= w << 8;
+		w |= w << 16;
 
+		len = n - (n % CPU_BURST_SIZE);
+		cpu_fill_burst(d, w, len);
+		d += len;
+		n -= len;
+
+		while(n >= WORD_SIZE)
+		{
+			*(word_t *)d = w;
+			d += WORD_SIZE;
+			n -= WORD_SIZE;
+		}
+	}
+
+	/* Fill the tail */
 	while(n)
 	{
 		*d++ = val;
@@ -58,3 +219,50 @@ void *memset(void *dest, int val, size_t n)
 
 	return dest;
 }
+
+int memcmp(const void *s1, const void *s2, size_t n)
+{
+	const unsigned char *a = s1;
+	const unsigned char *b = s2;
+
+	/* Skip identical words when both areas have the same alignment */
+	if((n >= SMALL_SIZE) &&
+	   ((((uintptr_t)a) & (WORD_SIZE - 1)) ==
+	    (((uintptr_t)b) & (WORD_SIZE - 1))))
+	{
+		while(!IS_WORD_ALIGNED(a))
+		{
+			if(*a != *b)
+			{
+				return (*a - *b);
+			}
+
+			a++;
+			b++;
+			n--;
+		}
+
+		/* The differing word, if any, is compared bytewise below */
+		while((n >= WORD_SIZE) &&
+		      (*(const word_t *)a == *(const word_t *)b))
+		{
+			a += WORD_SIZE;
+			b += WORD_SIZE;
+			n -= WORD_SIZE;
+		}
+	}
+
+	while(n)
+	{
+		if(*a != *b)
+		{
+			return (*a - *b);
+		}
+
+		a++;
+		b++;
+		n--;
+	}
+
+	return 0;
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file syscall.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * System call dispatch
+ */
+#include <kernel/errno.h>
+#include <kernel/grant.h>
+#include <kernel/sched.h>
+#include <kernel/syscall.h>
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+uintptr_t syscall_dispatch(uintptr_t p1, uintptr_t p2, uintptr_t p3,
+                           uintptr_t p4, uint32_t num)
+{
+	(void)p3;
+	(void)p4;
+
+	switch(num)
+	{
+		case SYSCALL_GRANT_ALLOC:
+			return (uintptr_t)grant_do_alloc();
+
+		case SYSCALL_GRANT_LEND:
+			return grant_do_lend((void *)p1, (task_t *)p2);
+
+		case SYSCALL_GRANT_RETURN:
+			return grant_do_return((void *)p1);
+
+		case SYSCALL_GRANT_FREE:
+			return grant_do_free((void *)p1);
+
+		case SYSCALL_TASK_EXIT:
+			sched_do_exit();
+			return 0;
+
+		default:
+			return ENOSYS;
+	}
+}
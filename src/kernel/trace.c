@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file trace.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Kernel event tracing implementation
+ */
+#include <cpu/cpu_utils.h>
+#include <kernel/clock.h>
+#include <kernel/trace.h>
+
+/*******************************************************************************
+ * Private definitions
+ ******************************************************************************/
+/** The trace buffer, dumped by the debugger */
+trace_buffer_t trace_buffer;
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+int trace_init(void)
+{
+	trace_buffer.version = TRACE_VERSION;
+	trace_buffer.nb_events = TRACE_NB_EVENTS;
+	trace_buffer.freq = clock_get_timestamp_freq();
+	trace_buffer.head = 0;
+
+	/* Start recording */
+	trace_buffer.magic = TRACE_MAGIC;
+
+	return 0;
+}
+
+void trace_record(trace_event_type type, uint16_t arg0, uint32_t arg1)
+{
+	trace_event *e;
+	uint32_t n;
+
+	if(trace_buffer.magic != TRACE_MAGIC)
+		return;
+
+	/* The timestamp sources are out of reach of unprivileged tasks */
+	if(!cpu_is_privileged())
+		return;
+
+	/*
+	 * Reserve a record atomically, so that interrupt handlers preempting a
+	 * writer get a record of their own without masking interrupts
+	 */
+	n = __atomic_fetch_add(&trace_buffer.head, 1, __ATOMIC_RELAXED);
+	e = &trace_buffer.events[n & (TRACE_NB_EVENTS - 1)];
+
+	/* Mark the record as partial until all fields are written */
+	e->seq = 0;
+	__atomic_signal_fence(__ATOMIC_SEQ_CST);
+	e->timestamp = clock_get_timestamp();
+	e->type = type;
+	e->arg0 = arg0;
+	e->arg1 = arg1;
+	__atomic_signal_fence(__ATOMIC_SEQ_CST);
+	e->seq = n + 1;
+}
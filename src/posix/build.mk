@@ -0,0 +1,16 @@
+# Retrieve the directory containing this makefile
+ROOT_DIR := $(shell dirname $(lastword $(MAKEFILE_LIST)))
+
+# List of object files to build in this directory
+OBJ += $(ROOT_DIR)/host.o $(ROOT_DIR)/handlers.o $(ROOT_DIR)/utils.o           \
+       $(ROOT_DIR)/scb.o $(ROOT_DIR)/systick.o $(ROOT_DIR)/task.o              \
+       $(ROOT_DIR)/mpu.o $(ROOT_DIR)/dwt.o $(ROOT_DIR)/string.o                \
+       $(ROOT_DIR)/rcc.o $(ROOT_DIR)/svc.o $(ROOT_DIR)/nvic.o
+
+# Stress workload
+ifeq ($(STRESS), 1)
+OBJ += $(ROOT_DIR)/stress.o
+endif
+
+# The host layer is the only file built against the host C library
+$(ROOT_DIR)/host.o: CFLAGS := $(filter-out -nostdinc, $(CFLAGS))
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file handlers.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Exception handlers, hosted port
+ */
+#include <cpu/cpu_task.h>
+#include <cpu/cpu_utils.h>
+#include <kernel/clock.h>
+#include <kernel/cyclic.h>
+#include <kernel/kdata.h>
+#include <kernel/sched.h>
+#include <posix/posix_host.h>
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+void posix_handler_tick(void)
+{
+	/* Start the new period first, together with the tick count update */
+	posix_systick_reload();
+	clock_tick();
+	kdata_tick();
+	sched_tick();
+#ifdef CONFIG_CYCLIC
+	cyclic_tick();
+#endif
+}
+
+void posix_handler_switch(void)
+{
+	cpu_task_save_context();
+
+	schedule();
+
+	cpu_set_privilege(sched_is_task_privileged());
+	cpu_task_restore_context();
+}
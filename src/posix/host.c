@@ -0,0 +1,403 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file host.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Host process services of the hosted port
+ *
+ * This is the only file of the port built against the host C library. It
+ * emulates the exception model of the Cortex-M3: the timer signal plays the
+ * role of SysTick, and context switches are deferred like PendSV until no
+ * exception is running and interrupts are unmasked.
+ */
+#include <posix/posix_host.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ * Private definitions
+ ******************************************************************************/
+#ifndef POSIX_STACK_SIZE
+/**
+ * Size of the host stack of each task in bytes. Task stacks allocated by the
+ * kernel are too small for host code and signal frames, they only hold a
+ * pointer to the context.
+ */
+#define POSIX_STACK_SIZE (64 * 1024)
+#endif
+
+#ifndef POSIX_HEAP_SIZE
+/** Size of the kernel heap in bytes */
+#define POSIX_HEAP_SIZE (1024 * 1024)
+#endif
+
+/** Stringify the value of a macro */
+#define STR(x) #x
+
+/** Stringify the value of a macro */
+#define XSTR(x) STR(x)
+
+/** Kernel heap, managed by kalloc between __bss_end and __stack_limit */
+char posix_heap[POSIX_HEAP_SIZE] __attribute__((aligned(16)));
+
+/*
+ * Stand-ins for the symbols of the linker script. Sections initialized by
+ * kernel_entry() are empty, the host loader has already set them up.
+ */
+asm(".globl __text_end, __ram_data_start, __ram_data_end, __rodata_end\n"
+    ".globl __ramfunc_start, __ramfunc_end, __ramfunc_load\n"
+    ".globl __bss_start, __bss_end, __stack_limit\n"
+    ".set __text_end, posix_heap\n"
+    ".set __ram_data_start, posix_heap\n"
+    ".set __ram_data_end, posix_heap\n"
+    ".set __rodata_end, posix_heap\n"
+    ".set __ramfunc_start, posix_heap\n"
+    ".set __ramfunc_end, posix_heap\n"
+    ".set __ramfunc_load, posix_heap\n"
+    ".set __bss_start, posix_heap\n"
+    ".set __bss_end, posix_heap\n"
+    ".set __stack_limit, posix_heap + " XSTR(POSIX_HEAP_SIZE) "\n");
+
+/** Task execution context */
+typedef struct
+{
+	ucontext_t uc;                  /**< Host context */
+	void (*func)(void *);           /**< Task entry point */
+	void *arg;                      /**< Task function parameter */
+	void (*stop_func)(void);        /**< Task termination routine */
+	int exited;                     /**< True once func has returned */
+	void *stack;                    /**< Host stack */
+} posix_context;
+
+/** Context of the process before the first switch, never resumed */
+static posix_context main_context;
+
+/** Running context */
+static posix_context *running = &main_context;
+
+/** Context of a terminated task, released by the next context to run */
+static posix_context *zombie;
+
+/** True while interrupts are masked */
+static volatile sig_atomic_t irq_disabled;
+
+/** True while an exception is running */
+static volatile sig_atomic_t in_exception;
+
+/** True if thread mode is unprivileged */
+static volatile sig_atomic_t thread_unprivileged;
+
+/** True when a timer tick has to be handled */
+static volatile sig_atomic_t tick_pending;
+
+/** True when a context switch has been requested */
+static volatile sig_atomic_t switch_pending;
+
+/** Set holding the timer signal */
+static sigset_t timer_set;
+
+/** Kernel entry point */
+void kernel_entry(void);
+
+/** Release the context of a terminated task, if any */
+static void reap(void)
+{
+	if(zombie == NULL)
+		return;
+
+	free(zombie->stack);
+	free(zombie);
+	zombie = NULL;
+}
+
+/**
+ * Run pending exceptions, ticks first, until none is left. Called with the
+ * timer signal blocked, so that exceptions do not nest.
+ */
+static void run_exceptions(void)
+{
+	in_exception = 1;
+
+	while(tick_pending || switch_pending)
+	{
+		if(tick_pending)
+		{
+			tick_pending = 0;
+			posix_handler_tick();
+		}
+		if(switch_pending)
+		{
+			switch_pending = 0;
+			posix_handler_switch();
+		}
+	}
+
+	in_exception = 0;
+}
+
+/**
+ * Run pending exceptions from thread mode, if interrupts are unmasked
+ */
+static void trigger_exceptions(void)
+{
+	sigset_t old;
+
+	if(irq_disabled || in_exception)
+		return;
+
+	sigprocmask(SIG_BLOCK, &timer_set, &old);
+	run_exceptions();
+	sigprocmask(SIG_SETMASK, &old, NULL);
+}
+
+/**
+ * Timer signal handler
+ * \param[in] sig Signal number
+ */
+static void timer_handler(int sig)
+{
+	(void)sig;
+
+	tick_pending = 1;
+
+	/* The tick is handled when interrupts get unmasked */
+	if(irq_disabled || in_exception)
+		return;
+
+	run_exceptions();
+}
+
+/**
+ * Entry point of new contexts, returns from the exception that switched to
+ * the context then runs the task
+ */
+static void context_start(void)
+{
+	posix_context *ctx = running;
+
+	reap();
+	in_exception = 0;
+	sigprocmask(SIG_UNBLOCK, &timer_set, NULL);
+	trigger_exceptions();
+
+	ctx->func(ctx->arg);
+
+	ctx->exited = 1;
+	ctx->stop_func();
+}
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+void *posix_context_create(void (*func)(void *), void *arg,
+                           void (*stop_func)(void))
+{
+	posix_context *ctx;
+	sigset_t old;
+
+	/* The host allocator is not reentrant, keep switches out of it */
+	sigprocmask(SIG_BLOCK, &timer_set, &old);
+	ctx = calloc(1, sizeof(*ctx));
+	if(ctx != NULL)
+	{
+		ctx->stack = malloc(POSIX_STACK_SIZE);
+		if(ctx->stack == NULL)
+		{
+			free(ctx);
+			ctx = NULL;
+		}
+	}
+	sigprocmask(SIG_SETMASK, &old, NULL);
+
+	if(ctx == NULL)
+		return NULL;
+
+	ctx->func = func;
+	ctx->arg = arg;
+	ctx->stop_func = stop_func;
+
+	getcontext(&ctx->uc);
+	ctx->uc.uc_stack.ss_sp = ctx->stack;
+	ctx->uc.uc_stack.ss_size = POSIX_STACK_SIZE;
+	ctx->uc.uc_link = NULL;
+	/* Started within the switch exception, see context_start() */
+	ctx->uc.uc_sigmask = timer_set;
+	makecontext(&ctx->uc, context_start, 0);
+
+	return ctx;
+}
+
+void posix_context_switch(void *ctx)
+{
+	posix_context *from = running;
+
+	if(ctx == from)
+		return;
+
+	if(from->exited)
+		zombie = from;
+	running = ctx;
+
+	swapcontext(&from->uc, &running->uc);
+
+	/* Resumed, possibly after a terminated task */
+	reap();
+}
+
+int posix_irq_disable(void)
+{
+	int flags = irq_disabled;
+
+	/* Like PRIMASK writes, ignored in unprivileged thread mode */
+	if(!posix_is_privileged())
+		return flags;
+
+	irq_disabled = 1;
+	asm volatile("" ::: "memory");
+
+	return flags;
+}
+
+void posix_irq_restore(int flags)
+{
+	if(!posix_is_privileged())
+		return;
+
+	asm volatile("" ::: "memory");
+	irq_disabled = flags;
+
+	if(!flags && (tick_pending || switch_pending))
+		trigger_exceptions();
+}
+
+void posix_set_privilege(int priv)
+{
+	thread_unprivileged = !priv;
+}
+
+int posix_is_privileged(void)
+{
+	return (in_exception || !thread_unprivileged);
+}
+
+void posix_svc_enter(void)
+{
+	sigprocmask(SIG_BLOCK, &timer_set, NULL);
+	in_exception = 1;
+}
+
+void posix_svc_exit(void)
+{
+	in_exception = 0;
+
+	/* Exceptions requested meanwhile follow, then back to thread mode */
+	if(!irq_disabled)
+		run_exceptions();
+	sigprocmask(SIG_UNBLOCK, &timer_set, NULL);
+}
+
+void posix_pend_switch(void)
+{
+	switch_pending = 1;
+	trigger_exceptions();
+}
+
+int posix_timer_start(unsigned long period_ns)
+{
+	struct itimerval it;
+
+	it.it_interval.tv_sec = period_ns / 1000000000UL;
+	it.it_interval.tv_usec = (period_ns % 1000000000UL) / 1000;
+	if((it.it_interval.tv_sec == 0) && (it.it_interval.tv_usec == 0))
+		it.it_interval.tv_usec = 1;
+	it.it_value = it.it_interval;
+
+	return (setitimer(ITIMER_REAL, &it, NULL) == 0) ? 0 : -1;
+}
+
+void posix_timer_stop(void)
+{
+	struct itimerval it = {{0, 0}, {0, 0}};
+
+	setitimer(ITIMER_REAL, &it, NULL);
+}
+
+unsigned long long posix_get_time_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((unsigned long long)ts.tv_sec * 1000000000ULL) + ts.tv_nsec;
+}
+
+void posix_idle(void)
+{
+	sigset_t empty;
+
+	sigemptyset(&empty);
+	sigsuspend(&empty);
+}
+
+void posix_print(const char *s)
+{
+	ssize_t ret;
+
+	ret = write(STDOUT_FILENO, s, strlen(s));
+	(void)ret;
+}
+
+void posix_exit(int status)
+{
+	exit(status);
+}
+
+/**
+ * Host process entry point, boots the kernel like the reset handler does
+ * \return Never returns, the kernel runs until the process is killed
+ */
+int main(void)
+{
+	struct sigaction sa;
+
+	sigemptyset(&timer_set);
+	sigaddset(&timer_set, SIGALRM);
+
+	sa.sa_handler = timer_handler;
+	sigemptyset(&sa.sa_mask);
+	sa.sa_flags = SA_RESTART;
+	sigaction(SIGALRM, &sa, NULL);
+
+	kernel_entry();
+
+	return 0;
+}
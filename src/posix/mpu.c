@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file mpu.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Memory protection unit emulation, hosted port
+ *
+ * The host port has no MPU, the kernel then runs without memory protection.
+ */
+#include <cpu/cpu_mpu.h>
+#include <kernel/errno.h>
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+int mpu_get_nb_regions(void)
+{
+	return 0;
+}
+
+int mpu_region_compute(int region, void *base, size_t size, uint32_t attr,
+                       mpu_region_t *r)
+{
+	(void)region;
+	(void)base;
+	(void)size;
+	(void)attr;
+	(void)r;
+
+	return ENOTSUP;
+}
+
+void mpu_region_load(const mpu_region_t *r)
+{
+	(void)r;
+}
+
+int mpu_region_setup(int region, void *base, size_t size, uint32_t attr)
+{
+	(void)region;
+	(void)base;
+	(void)size;
+	(void)attr;
+
+	return ENOTSUP;
+}
+
+int mpu_region_disable(int region)
+{
+	(void)region;
+
+	return ENOTSUP;
+}
+
+int mpu_enable(void)
+{
+	return ENOTSUP;
+}
+
+int mpu_disable(void)
+{
+	return ENOTSUP;
+}
+
+int mpu_is_enabled(void)
+{
+	return 0;
+}
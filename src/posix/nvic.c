@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file nvic.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Nested vectored interrupt controller, hosted port
+ *
+ * The host process has no peripheral interrupts to route, only SysTick and
+ * PendSV are emulated (see host.c). External IRQs can be registered but are
+ * never taken.
+ */
+#include <cpu/cpu_nvic.h>
+#include <kernel/errno.h>
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+int nvic_irq_enable(int irq)
+{
+	(void)irq;
+
+	return ENOTSUP;
+}
+
+int nvic_irq_disable(int irq)
+{
+	(void)irq;
+
+	return ENOTSUP;
+}
+
+int nvic_irq_clear(int irq)
+{
+	(void)irq;
+
+	return ENOTSUP;
+}
+
+int nvic_irq_set_pending(int irq)
+{
+	(void)irq;
+
+	return ENOTSUP;
+}
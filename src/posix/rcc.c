@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file rcc.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Reset and clock control emulation, hosted port
+ *
+ * No clock is actually configured, the requested clock tree is only checked
+ * and its frequencies published, so that the kernel computes the same periods
+ * as on the target.
+ */
+#include <kernel/errno.h>
+#include <soc/soc_rcc.h>
+
+/*******************************************************************************
+ * Private definitions
+ ******************************************************************************/
+/** Lowest PLL multiplication factor */
+#define PLL_MUL_MIN (2)
+
+/** Highest PLL multiplication factor */
+#define PLL_MUL_MAX (16)
+
+/** Highest ADC prescaler division factor */
+#define ADC_DIV_MAX (8)
+
+/** SYSCLK frequency */
+static unsigned int sysclk_freq = RCC_HSI_FREQ;
+
+/** APB1 clock frequency */
+static unsigned int pclk1_freq = RCC_HSI_FREQ;
+
+/** ADC clock frequency */
+static unsigned int adcclk_freq = RCC_HSI_FREQ / 2;
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+int rcc_setup(unsigned int hse_freq, unsigned int sysclk_freq_req)
+{
+	unsigned int div;
+
+	if((hse_freq == 0) || (sysclk_freq_req % hse_freq != 0) ||
+	   (sysclk_freq_req / hse_freq < PLL_MUL_MIN) ||
+	   (sysclk_freq_req / hse_freq > PLL_MUL_MAX) ||
+	   (sysclk_freq_req > RCC_MAX_SYSCLK_FREQ))
+	{
+		return EINVAL;
+	}
+
+	sysclk_freq = sysclk_freq_req;
+	pclk1_freq = (sysclk_freq > RCC_MAX_PCLK1_FREQ) ? (sysclk_freq / 2) :
+	                                                  sysclk_freq;
+
+	/* ADC prescaler divides PCLK2 by 2, 4, 6 or 8 */
+	for(div = 2; div < ADC_DIV_MAX; div += 2)
+	{
+		if(sysclk_freq / div <= RCC_MAX_ADCCLK_FREQ)
+			break;
+	}
+	adcclk_freq = sysclk_freq / div;
+
+	return 0;
+}
+
+unsigned int rcc_get_sysclk_freq(void)
+{
+	return sysclk_freq;
+}
+
+unsigned int rcc_get_hclk_freq(void)
+{
+	return sysclk_freq;
+}
+
+unsigned int rcc_get_pclk1_freq(void)
+{
+	return pclk1_freq;
+}
+
+unsigned int rcc_get_pclk2_freq(void)
+{
+	return sysclk_freq;
+}
+
+unsigned int rcc_get_adcclk_freq(void)
+{
+	return adcclk_freq;
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file scb.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * System control block emulation, hosted port
+ */
+#include <cpu/cpu_scb.h>
+#include <kernel/errno.h>
+#include <kernel/stddef.h>
+#include <posix/posix_host.h>
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+int scb_get_cpuid(cpuid_t *cpuid)
+{
+	if(cpuid == NULL)
+	{
+		return EINVAL;
+	}
+
+	/* Not a Cortex-M3, callers checking the part number must not match */
+	cpuid->implementer = 0;
+	cpuid->variant = 0;
+	cpuid->part = 0;
+	cpuid->revision = 0;
+
+	return 0;
+}
+
+int scb_set_pendSV(void)
+{
+	/* The system control space is privileged, the access would fault */
+	if(!posix_is_privileged())
+	{
+		posix_print("bus fault: PendSV set by unprivileged code\n");
+		posix_exit(1);
+	}
+
+	posix_pend_switch();
+
+	return 0;
+}
+
+int scb_clear_pendSV(void)
+{
+	return ENOTSUP;
+}
+
+int scb_clear_systick(void)
+{
+	return ENOTSUP;
+}
+
+int scb_is_systick_pending(void)
+{
+	/* Late ticks are accounted for by systick_get_val() */
+	return 0;
+}
+
+int scb_request_reset(void)
+{
+	return ENOTSUP;
+}
+
+int scb_set_deep_sleep(int status)
+{
+	(void)status;
+
+	return ENOTSUP;
+}
+
+int scb_set_trap_on_div_by_zero(int status)
+{
+	(void)status;
+
+	return ENOTSUP;
+}
+
+int scb_set_mem_manage_fault(int status)
+{
+	(void)status;
+
+	return ENOTSUP;
+}
+
+int scb_get_usage_fault_information(void *stacked_pc, fault_info_t *info)
+{
+	(void)stacked_pc;
+	(void)info;
+
+	return ENOTSUP;
+}
+
+int scb_get_bus_fault_information(void *stacked_pc, fault_info_t *info)
+{
+	(void)stacked_pc;
+	(void)info;
+
+	return ENOTSUP;
+}
+
+int scb_get_mem_manage_fault_information(void *stacked_pc, fault_info_t *info)
+{
+	(void)stacked_pc;
+	(void)info;
+
+	return ENOTSUP;
+}
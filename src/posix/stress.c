@@ -0,0 +1,616 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file stress.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Scheduler and allocator stress workload of the hosted port
+ *
+ * Built with 'make HOSTED=1 STRESS=1', the workload runs at boot in place of
+ * an application and ends the process with its result, so that it can be run
+ * by scripts. Each worker task runs a fixed number of rounds of one kind:
+ * yielding, sleeping with slack, allocating and checking a block, or spinning
+ * through its quantum. The stress task checks that every round completes in
+ * time, that the clock never goes backwards, and that the heap is back to its
+ * initial state once all the workers have terminated.
+ *
+ * A preemption threshold scenario runs first: task A (priority 1, threshold
+ * 3) is preempted within its quantum by task C (priority 5), which makes task
+ * B (priority 2) ready and terminates. A must resume before B runs.
+ *
+ * Then an unprivileged task, which cannot mask IRQs, tries to use the heap:
+ * allocations must fail and frees must be ignored, leaving the heap as it was.
+ *
+ * Built with CYCLIC=1, a cyclic executive scenario runs last, once the workers
+ * are done, as the executive cannot be stopped. Its frame has a slot which
+ * overruns into the next two: the first of them is skipped, the second starts
+ * late. Slot statistics and overrun reports must match, and a round-robin task
+ * must never see a slot function in progress.
+ */
+#include <cpu/cpu_utils.h>
+#include <kernel/clock.h>
+#include <kernel/cyclic.h>
+#include <kernel/errno.h>
+#include <kernel/kalloc.h>
+#include <kernel/sched.h>
+#include <kernel/stddef.h>
+#include <posix/posix_host.h>
+#include <posix/posix_stress.h>
+
+/*******************************************************************************
+ * Private definitions
+ ******************************************************************************/
+/** Number of worker tasks */
+#define STRESS_NB_TASKS (500)
+
+/** Number of rounds run by each worker */
+#define STRESS_NB_ROUNDS (20)
+
+/** Stack size of the worker tasks in bytes */
+#define STRESS_STACK_SIZE (256)
+
+/** Number of priority levels of the workers, the stress task is above */
+#define STRESS_NB_PRIORITIES (3)
+
+/** Number of ticks the stress task sleeps between two checks */
+#define STRESS_CHECK_TICKS (10)
+
+/** Number of ticks the run may last before it is considered stuck */
+#define STRESS_TIMEOUT_TICKS (3000)
+
+/** Number of iterations of a spinning round */
+#define STRESS_SPIN_LOOPS (10000)
+
+/** Largest block allocated by a round, in bytes */
+#define STRESS_MAX_BLOCK (256)
+
+/** Priority of the stress task during the threshold scenario */
+#define THRESHOLD_PRIORITY (6)
+
+/** Number of ticks the threshold scenario may last, and quantum of task A */
+#define THRESHOLD_TICKS (10)
+
+/** Number of ticks the unprivileged scenario may last */
+#define UNPRIV_TICKS (5)
+
+/** Length of the major frame of the cyclic scenario in ticks */
+#define FRAME_TICKS (10)
+
+/** Minimum number of frames the cyclic scenario lasts */
+#define FRAME_COUNT (5)
+
+/** Number of ticks the overrunning slot function runs for */
+#define FRAME_OVERRUN_TICKS (4)
+
+/** Slots of the cyclic scenario */
+enum
+{
+	SLOT_FIRST,             /**< Starts the frame */
+	SLOT_LONG,              /**< Runs over the next two slots */
+	SLOT_SKIPPED,           /**< Dropped, started during SLOT_LONG */
+	SLOT_LATE,              /**< Runs once SLOT_LONG returns */
+	FRAME_NB_SLOTS          /**< Number of slots */
+};
+
+/** Kinds of workers */
+enum
+{
+	STRESS_YIELD,           /**< Yields each round */
+	STRESS_SLEEP,           /**< Sleeps a few ticks each round */
+	STRESS_ALLOC,           /**< Allocates, fills and checks a block */
+	STRESS_SPIN,            /**< Burns CPU time each round */
+	STRESS_NB_KINDS         /**< Number of kinds */
+};
+
+/** Number of rounds completed by each worker */
+static volatile unsigned int rounds[STRESS_NB_TASKS];
+
+/** Set by a worker which found one of its blocks corrupted */
+static volatile unsigned char corrupted[STRESS_NB_TASKS];
+
+/** Names of the threshold scenario tasks, in the order they ran */
+static char threshold_order[4];
+
+/** Number of entries in threshold_order */
+static volatile unsigned int threshold_len;
+
+/** Set once task C of the threshold scenario has run */
+static volatile int threshold_c_done;
+
+/** Result of the unprivileged task, 0 if it passed, -1 until it has run */
+static volatile int unpriv_result = -1;
+
+#ifdef CONFIG_CYCLIC
+static void slot_short(void *arg);
+static void slot_long(void *arg);
+static void frame_overrun(unsigned int slot);
+
+/** Slots of the cyclic scenario */
+static const cyclic_slot frame_slots[FRAME_NB_SLOTS] =
+{
+	{ 0, 1, slot_short, NULL },
+	{ 2, 2, slot_long, NULL },
+	{ 4, 1, slot_short, NULL },
+	{ 5, 1, slot_short, NULL }
+};
+
+/** Cyclic schedule of the scenario */
+static const cyclic_table frame_table =
+{
+	FRAME_TICKS,
+	frame_slots,
+	FRAME_NB_SLOTS,
+	STRESS_STACK_SIZE,
+	frame_overrun
+};
+
+/** True while a slot function of the cyclic scenario runs */
+static volatile int slot_active;
+
+/** Number of overruns reported to the scenario */
+static volatile unsigned int overrun_calls;
+
+/** Slot of the last overrun reported */
+static volatile unsigned int overrun_slot;
+
+/** Set once the round-robin observer task has run */
+static volatile int observer_ran;
+
+/** Number of times the observer found a slot function in progress */
+static volatile unsigned int observer_in_slot;
+
+/** Set to terminate the observer */
+static volatile int frames_done;
+#endif
+
+/**
+ * Print an unsigned decimal number
+ * \param[in] v The number to print
+ */
+static void print_uint(unsigned long v)
+{
+	char digits[21];
+	unsigned int i = sizeof(digits) - 1;
+
+	digits[i] = '\0';
+	do
+	{
+		digits[--i] = '0' + (v % 10);
+		v /= 10;
+	} while(v != 0);
+
+	posix_print(&digits[i]);
+}
+
+/**
+ * Report a failure and end the process
+ * \param[in] why Description of the failure
+ */
+static void fail(const char *why)
+{
+	posix_print("stress: FAILED, ");
+	posix_print(why);
+	posix_print("\n");
+	posix_exit(1);
+}
+
+/**
+ * Record that a task of the threshold scenario ran
+ * \param[in] name Name of the task
+ */
+static void threshold_record(char name)
+{
+	int flags;
+
+	flags = cpu_irq_disable();
+	if(threshold_len < sizeof(threshold_order) - 1)
+		threshold_order[threshold_len++] = name;
+	cpu_irq_restore(flags);
+}
+
+/**
+ * Task A of the threshold scenario, runs until C has run
+ * \param[in] arg Unused
+ */
+static void threshold_a(void *arg)
+{
+	(void)arg;
+
+	while(!threshold_c_done)
+		;
+
+	threshold_record('A');
+}
+
+/**
+ * Task B of the threshold scenario
+ * \param[in] arg Unused
+ */
+static void threshold_b(void *arg)
+{
+	(void)arg;
+
+	threshold_record('B');
+}
+
+/**
+ * Task C of the threshold scenario, wakes up while A runs, makes B ready and
+ * terminates
+ * \param[in] arg Unused
+ */
+static void threshold_c(void *arg)
+{
+	task_t *b;
+
+	(void)arg;
+
+	sched_sleep_ticks(2, 0);
+
+	b = sched_create_task(threshold_b, NULL, STRESS_STACK_SIZE, 1, 0);
+	if(b != NULL)
+		sched_set_priority(b, 2, 2);
+
+	threshold_record('C');
+	threshold_c_done = 1;
+}
+
+/**
+ * Run the preemption threshold scenario, ends the process on failure
+ */
+static void check_threshold(void)
+{
+	task_t *a, *c;
+
+	sched_set_priority(sched_get_current_task(), THRESHOLD_PRIORITY,
+	                   THRESHOLD_PRIORITY);
+
+	a = sched_create_task(threshold_a, NULL, STRESS_STACK_SIZE, 1,
+	                      THRESHOLD_TICKS);
+	c = sched_create_task(threshold_c, NULL, STRESS_STACK_SIZE, 1, 0);
+	if((a == NULL) || (c == NULL))
+		fail("task creation");
+	sched_set_priority(a, 1, 3);
+	sched_set_priority(c, 5, 5);
+
+	sched_sleep_ticks(THRESHOLD_TICKS, 0);
+
+	threshold_order[threshold_len] = '\0';
+	if((threshold_order[0] != 'C') || (threshold_order[1] != 'A') ||
+	   (threshold_order[2] != 'B'))
+	{
+		posix_print("stress: threshold scenario ran ");
+		posix_print(threshold_order);
+		posix_print(", expected CAB\n");
+		fail("preemption threshold");
+	}
+}
+
+/**
+ * Unprivileged task, tries to allocate and to free a block
+ * \param[in] arg Block allocated by the stress task
+ */
+static void unpriv_task(void *arg)
+{
+	kalloc_stats stats;
+	void *p;
+
+	p = kmalloc(16);
+	if(p != NULL)
+	{
+		unpriv_result = 1;
+		return;
+	}
+
+	kfree(arg);
+	unpriv_result = (kalloc_get_stats(&stats) == EPERM) ? 0 : 1;
+}
+
+/**
+ * Run the unprivileged heap access scenario, ends the process on failure
+ */
+static void check_unprivileged(void)
+{
+	kalloc_stats before, after;
+	task_t *t;
+	void *p;
+
+	p = kmalloc(16);
+	if(p == NULL)
+		fail("allocation failure");
+	kalloc_get_stats(&before);
+
+	t = sched_create_task(unpriv_task, p, STRESS_STACK_SIZE, 0, 0);
+	if(t == NULL)
+		fail("task creation");
+
+	/* The task has run and terminated by then, its memory is released */
+	sched_sleep_ticks(UNPRIV_TICKS, 0);
+
+	kalloc_get_stats(&after);
+	if((unpriv_result != 0) || (after.free_bytes != before.free_bytes))
+		fail("unprivileged heap access");
+
+	kfree(p);
+}
+
+#ifdef CONFIG_CYCLIC
+/**
+ * Slot function returning at once
+ * \param[in] arg Unused
+ */
+static void slot_short(void *arg)
+{
+	(void)arg;
+
+	slot_active = 1;
+	slot_active = 0;
+}
+
+/**
+ * Slot function running for longer than its slot
+ * \param[in] arg Unused
+ */
+static void slot_long(void *arg)
+{
+	uint64_t end;
+
+	(void)arg;
+
+	slot_active = 1;
+	end = clock_get_ticks() + FRAME_OVERRUN_TICKS;
+	while(clock_get_ticks() < end)
+		;
+	slot_active = 0;
+}
+
+/**
+ * Overrun report of the cyclic scenario, called from the tick interrupt
+ * \param[in] slot Index of the overrunning slot
+ */
+static void frame_overrun(unsigned int slot)
+{
+	overrun_calls++;
+	overrun_slot = slot;
+}
+
+/**
+ * Round-robin task watching for slot functions in progress
+ * \param[in] arg Unused
+ */
+static void frame_observer(void *arg)
+{
+	(void)arg;
+
+	while(!frames_done)
+	{
+		observer_ran = 1;
+		if(slot_active)
+			observer_in_slot++;
+	}
+}
+
+/**
+ * Run the cyclic executive scenario, ends the process on failure
+ */
+static void check_cyclic(void)
+{
+	cyclic_slot_stats s[FRAME_NB_SLOTS];
+	unsigned int i, runs;
+	task_t *t;
+	int flags;
+
+	t = sched_create_task(frame_observer, NULL, STRESS_STACK_SIZE, 1, 0);
+	if(t == NULL)
+		fail("task creation");
+	if(cyclic_start(&frame_table) != 0)
+		fail("cyclic executive start");
+
+	sched_sleep_ticks(FRAME_COUNT * FRAME_TICKS, 0);
+
+	/* Read all the statistics between the same two slots */
+	flags = cpu_irq_disable();
+	for(i = 0; i < FRAME_NB_SLOTS; i++)
+		cyclic_get_stats(i, &s[i]);
+	cpu_irq_restore(flags);
+	frames_done = 1;
+
+	/* The task may run before the long slot of the frame, or after it */
+	runs = s[SLOT_LONG].runs;
+	if((s[SLOT_FIRST].runs < FRAME_COUNT) ||
+	   ((s[SLOT_FIRST].runs != runs) && (s[SLOT_FIRST].runs != runs + 1)))
+		fail("cyclic slot runs");
+	if((s[SLOT_LONG].overruns != runs) || (overrun_calls != runs) ||
+	   (overrun_slot != SLOT_LONG))
+		fail("cyclic overrun count");
+	if((s[SLOT_SKIPPED].runs != 0) || (s[SLOT_SKIPPED].skipped != runs) ||
+	   (s[SLOT_LATE].runs != runs))
+		fail("cyclic skip count");
+	if(s[SLOT_FIRST].overruns || s[SLOT_FIRST].skipped ||
+	   s[SLOT_LONG].skipped || s[SLOT_LATE].overruns ||
+	   s[SLOT_LATE].skipped)
+		fail("cyclic slot statistics");
+	if(!observer_ran || observer_in_slot)
+		fail("round-robin task ran within a slot");
+}
+#endif
+
+/**
+ * Allocate a block, fill it, let other tasks run and check it is unchanged
+ * \param[in] id Index of the worker
+ * \param[in] round Index of the round
+ * \retval 0 Success
+ * \retval 1 The block could not be allocated or was corrupted
+ */
+static int alloc_round(unsigned int id, unsigned int round)
+{
+	unsigned char *p;
+	size_t size, i;
+	int ret = 0;
+
+	size = 1 + ((id * 37) + (round * 11)) % STRESS_MAX_BLOCK;
+	p = kmalloc(size);
+	if(p == NULL)
+		return 1;
+
+	for(i = 0; i < size; i++)
+		p[i] = (unsigned char)(id + i);
+
+	sched_yield();
+
+	for(i = 0; i < size; i++)
+	{
+		if(p[i] != (unsigned char)(id + i))
+			ret = 1;
+	}
+
+	kfree(p);
+
+	return ret;
+}
+
+/**
+ * Worker task routine
+ * \param[in] arg Index of the worker
+ */
+static void worker(void *arg)
+{
+	unsigned int id = (uintptr_t)arg;
+	unsigned int round;
+	volatile unsigned int i;
+
+	for(round = 0; round < STRESS_NB_ROUNDS; round++)
+	{
+		switch(id % STRESS_NB_KINDS)
+		{
+		case STRESS_YIELD:
+			sched_yield();
+			break;
+		case STRESS_SLEEP:
+			sched_sleep_ticks(1 + (id % 7), id % 3);
+			break;
+		case STRESS_ALLOC:
+			if(alloc_round(id, round) != 0)
+				corrupted[id] = 1;
+			break;
+		default:
+			for(i = 0; i < STRESS_SPIN_LOOPS; i++)
+				;
+			break;
+		}
+
+		rounds[id]++;
+	}
+}
+
+/**
+ * Check whether all the workers have completed their rounds
+ * \return True if they have, false otherwise
+ */
+static int all_rounds_done(void)
+{
+	unsigned int i;
+
+	for(i = 0; i < STRESS_NB_TASKS; i++)
+	{
+		if(corrupted[i])
+			fail("corrupted block or allocation failure");
+		if(rounds[i] != STRESS_NB_ROUNDS)
+			return 0;
+	}
+
+	return 1;
+}
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+void posix_stress_main(void *arg)
+{
+	kalloc_stats heap_before, heap_after;
+	uint64_t start, last_ns, now_ns;
+	unsigned int i, max_load = 0;
+	uint8_t prio;
+	task_t *t;
+
+	(void)arg;
+
+	check_threshold();
+	check_unprivileged();
+
+	/* Create all the workers before any of them runs */
+	sched_set_priority(sched_get_current_task(), STRESS_NB_PRIORITIES,
+	                   STRESS_NB_PRIORITIES);
+	kalloc_get_stats(&heap_before);
+
+	for(i = 0; i < STRESS_NB_TASKS; i++)
+	{
+		t = sched_create_task(worker, (void *)(uintptr_t)i,
+		                      STRESS_STACK_SIZE, 1, 1 + (i % 5));
+		if(t == NULL)
+			fail("task creation");
+		prio = (i / STRESS_NB_KINDS) % STRESS_NB_PRIORITIES;
+		sched_set_priority(t, prio, prio);
+	}
+
+	/* Watch the workers until they have all run and been released */
+	start = clock_get_ticks();
+	last_ns = clock_get_ns();
+	while(1)
+	{
+		sched_sleep_ticks(STRESS_CHECK_TICKS, 0);
+
+		now_ns = clock_get_ns();
+		if(now_ns < last_ns)
+			fail("clock went backwards");
+		last_ns = now_ns;
+
+		if(sched_get_cpu_load() > max_load)
+			max_load = sched_get_cpu_load();
+
+		kalloc_get_stats(&heap_after);
+		if(all_rounds_done() &&
+		   (heap_after.free_bytes == heap_before.free_bytes))
+			break;
+
+		if(clock_get_ticks() - start > STRESS_TIMEOUT_TICKS)
+			fail("timeout");
+	}
+
+#ifdef CONFIG_CYCLIC
+	check_cyclic();
+#endif
+
+	posix_print("stress: ");
+	print_uint(STRESS_NB_TASKS);
+	posix_print(" tasks, ");
+	print_uint(STRESS_NB_ROUNDS);
+	posix_print(" rounds, ");
+	print_uint(clock_get_ticks() - start);
+	posix_print(" ticks, peak load ");
+	print_uint(max_load);
+	posix_print(" permille, passed\n");
+	posix_exit(0);
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file string.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * CPU-specific memory block operations, hosted port
+ */
+#include <cpu/cpu_string.h>
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+void cpu_copy_burst(void *dest, const void *src, size_t n)
+{
+	uint32_t *d = dest;
+	const uint32_t *s = src;
+
+	for(n /= sizeof(uint32_t); n > 0; n--)
+		*d++ = *s++;
+}
+
+void cpu_copy_burst_backward(void *dest_end, const void *src_end, size_t n)
+{
+	uint32_t *d = dest_end;
+	const uint32_t *s = src_end;
+
+	for(n /= sizeof(uint32_t); n > 0; n--)
+		*--d = *--s;
+}
+
+void cpu_fill_burst(void *dest, uint32_t word, size_t n)
+{
+	uint32_t *d = dest;
+
+	for(n /= sizeof(uint32_t); n > 0; n--)
+		*d++ = word;
+}
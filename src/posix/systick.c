@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file systick.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * SysTick emulation, hosted port
+ *
+ * The counter value is computed from the host monotonic clock, and the
+ * interrupt is the timer signal.
+ */
+#include <cpu/cpu_systick.h>
+#include <kernel/errno.h>
+#include <posix/posix_host.h>
+#include <soc/soc_rcc.h>
+
+/*******************************************************************************
+ * Private definitions
+ ******************************************************************************/
+/** Nanoseconds per second */
+#define NS_PER_S (1000000000ULL)
+
+/** Configured SysTick frequency */
+static unsigned int systick_freq;
+
+/** Frequency of the clock driving the SysTick counter */
+static unsigned int systick_clk_freq;
+
+/** Number of counter clock cycles per SysTick period */
+static uint32_t systick_period;
+
+/** Number of cycles between two reloads of the running counter, 0 if stopped */
+static uint32_t counter_load;
+
+/** Clock frequency of the running counter */
+static unsigned int counter_clk;
+
+/** Host time of the last reload of the counter */
+static unsigned long long counter_start;
+
+/** True while the interrupt is enabled */
+static int counter_irq;
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+int systick_setup(unsigned int freq, unsigned int ahb_freq)
+{
+	uint32_t load;
+
+	load = (freq == 0) ? 0 : (ahb_freq / freq);
+	if(load < 2)
+	{
+		systick_freq = 0;
+		systick_clk_freq = 0;
+		systick_period = 0;
+		return EINVAL;
+	}
+
+	systick_freq = ahb_freq / load;
+	systick_clk_freq = ahb_freq;
+	systick_period = load;
+
+	counter_load = load;
+	counter_clk = ahb_freq;
+	counter_start = posix_get_time_ns();
+
+	return 0;
+}
+
+int systick_start_counter(void)
+{
+	counter_load = SYSTICK_VAL_MASK + 1;
+	counter_clk = rcc_get_hclk_freq();
+	counter_start = posix_get_time_ns();
+
+	return 0;
+}
+
+int systick_enable(void)
+{
+	unsigned long period_ns;
+
+	if(systick_period == 0)
+		return EINVAL;
+
+	period_ns = ((unsigned long long)systick_period * NS_PER_S) /
+	            systick_clk_freq;
+
+	counter_start = posix_get_time_ns();
+	counter_irq = 1;
+
+	return (posix_timer_start(period_ns) == 0) ? 0 : EINVAL;
+}
+
+int systick_disable(void)
+{
+	posix_timer_stop();
+	counter_irq = 0;
+
+	return 0;
+}
+
+unsigned int systick_get_freq(void)
+{
+	return systick_freq;
+}
+
+unsigned int systick_get_clock_freq(void)
+{
+	return systick_clk_freq;
+}
+
+uint32_t systick_get_period(void)
+{
+	return systick_period;
+}
+
+uint32_t systick_get_val(void)
+{
+	unsigned long long elapsed, cycles;
+
+	if(counter_load == 0)
+		return 0;
+
+	elapsed = posix_get_time_ns() - counter_start;
+	cycles = (elapsed * (counter_clk / 1000)) / (NS_PER_S / 1000);
+
+	if(!counter_irq)
+		return (counter_load - 1) - (cycles % counter_load);
+
+	/*
+	 * The period ends when its tick is handled rather than when the signal
+	 * is due, hold the counter above 0 until then
+	 */
+	if(cycles >= counter_load - 1)
+		return 1;
+
+	return (counter_load - 1) - cycles;
+}
+
+void posix_systick_reload(void)
+{
+	counter_start = posix_get_time_ns();
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file task.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * CPU-specific task handling routines, hosted port
+ *
+ * The stack given by the kernel only holds a pointer to the host context of
+ * the task, which runs on a host stack of its own.
+ */
+#include <cpu/cpu_task.h>
+#include <cpu/cpu_utils.h>
+#include <kernel/stddef.h>
+#include <posix/posix_host.h>
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+void * cpu_task_create_context(void *sp, void *func, void *arg, void *stop_func)
+{
+	void **csp;
+
+	csp = sp;
+	csp--;
+	*csp = posix_context_create((void (*)(void *))func, arg,
+	                            (void (*)(void))stop_func);
+	if(*csp == NULL)
+		return NULL;
+
+	return csp;
+}
+
+void cpu_task_save_context(void)
+{
+	/* The context is saved by the switch itself */
+}
+
+void cpu_task_restore_context(void)
+{
+	posix_context_switch(*(void **)CPU_GET_PSP());
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file utils.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Low-level CPU-related primitives, hosted port
+ */
+#include <cpu/cpu_utils.h>
+#include <kernel/errno.h>
+#include <posix/posix_host.h>
+
+/*******************************************************************************
+ * Private definitions
+ ******************************************************************************/
+/** Emulated process stack pointer, holds the kernel view of the task stack */
+void *cpu_psp;
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+void cpu_irq_restore(int flags)
+{
+	posix_irq_restore(flags);
+}
+
+int cpu_irq_enable(void)
+{
+	int flags;
+
+	flags = posix_irq_disable();
+	posix_irq_restore(0);
+
+	return flags;
+}
+
+int cpu_irq_disable(void)
+{
+	return posix_irq_disable();
+}
+
+int cpu_irqoff_reset_stats(void)
+{
+	return ENOTSUP;
+}
+
+int cpu_irqoff_get_stats(cpu_irqoff_stats *stats)
+{
+	(void)stats;
+
+	return ENOTSUP;
+}
+
+void cpu_dmb(void)
+{
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+void cpu_dsb(void)
+{
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+void cpu_isb(void)
+{
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+void cpu_wfi(void)
+{
+	posix_idle();
+}
+
+uint32_t cpu_read_psr(void)
+{
+	/* Thread mode, no exception number */
+	return 0;
+}
+
+void cpu_set_privilege(unsigned int priv)
+{
+	/* Tasks share the rights of the process, only the level is tracked */
+	posix_set_privilege(priv);
+}
+
+int cpu_is_privileged(void)
+{
+	return posix_is_privileged();
+}
@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file rcc.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Reset and clock control driver
+ */
+#include <kernel/errno.h>
+#include <kernel/stdint.h>
+#include <soc/soc_mapping.h>
+#include <soc/soc_rcc.h>
+
+/*******************************************************************************
+ * Private definitions
+ ******************************************************************************/
+/** RCC register map */
+typedef struct
+{
+	uint32_t cr;         /**< Clock control register */
+	uint32_t cfgr;       /**< Clock configuration register */
+	uint32_t cir;        /**< Clock interrupt register */
+	uint32_t apb2rstr;   /**< APB2 peripheral reset register */
+	uint32_t apb1rstr;   /**< APB1 peripheral reset register */
+	uint32_t ahbenr;     /**< AHB peripheral clock enable register */
+	uint32_t apb2enr;    /**< APB2 peripheral clock enable register */
+	uint32_t apb1enr;    /**< APB1 peripheral clock enable register */
+	uint32_t bdcr;       /**< Backup domain control register */
+	uint32_t csr;        /**< Control/status register */
+} rcc_regs;
+
+/** Flash interface register map */
+typedef struct
+{
+	uint32_t acr;        /**< Access control register */
+	uint32_t keyr;       /**< Key register */
+	uint32_t optkeyr;    /**< Option key register */
+	uint32_t sr;         /**< Status register */
+	uint32_t cr;         /**< Control register */
+	uint32_t ar;         /**< Address register */
+	uint32_t reserved;   /**< Reserved */
+	uint32_t obr;        /**< Option byte register */
+	uint32_t wrpr;       /**< Write protection register */
+} flash_regs;
+
+/* CR register fields */
+/** External oscillator enable bit */
+#define RCC_CR_HSEON (1U << 16)
+
+/** External oscillator ready bit */
+#define RCC_CR_HSERDY (1U << 17)
+
+/** PLL enable bit */
+#define RCC_CR_PLLON (1U << 24)
+
+/** PLL ready bit */
+#define RCC_CR_PLLRDY (1U << 25)
+
+/* CFGR register fields */
+/** System clock switch mask */
+#define RCC_CFGR_SW_MASK (3U)
+
+/** Internal oscillator selected as system clock */
+#define RCC_CFGR_SW_HSI (0U)
+
+/** PLL selected as system clock */
+#define RCC_CFGR_SW_PLL (2U)
+
+/** System clock switch status mask */
+#define RCC_CFGR_SWS_MASK (3U << 2)
+
+/** Internal oscillator used as system clock */
+#define RCC_CFGR_SWS_HSI (0U << 2)
+
+/** PLL used as system clock */
+#define RCC_CFGR_SWS_PLL (2U << 2)
+
+/** AHB prescaler mask (AHB is never divided by this driver) */
+#define RCC_CFGR_HPRE_MASK (0xFU << 4)
+
+/** APB1 prescaler mask */
+#define RCC_CFGR_PPRE1_MASK (7U << 8)
+
+/** APB1 clock is HCLK divided by 2 */
+#define RCC_CFGR_PPRE1_DIV_2 (4U << 8)
+
+/** APB2 prescaler mask (APB2 is never divided by this driver) */
+#define RCC_CFGR_PPRE2_MASK (7U << 11)
+
+/** Position of the ADC prescaler field */
+#define RCC_CFGR_ADCPRE_SHIFT (14)
+
+/** ADC prescaler mask */
+#define RCC_CFGR_ADCPRE_MASK (3U << RCC_CFGR_ADCPRE_SHIFT)
+
+/** PLL fed by the external oscillator */
+#define RCC_CFGR_PLLSRC_HSE (1U << 16)
+
+/** External oscillator divided by 2 before the PLL */
+#define RCC_CFGR_PLLXTPRE (1U << 17)
+
+/** Position of the PLL multiplication factor field */
+#define RCC_CFGR_PLLMUL_SHIFT (18)
+
+/** PLL multiplication factor mask */
+#define RCC_CFGR_PLLMUL_MASK (0xFU << RCC_CFGR_PLLMUL_SHIFT)
+
+/** USB clock is the PLL output not divided (PLL divided by 1.5 otherwise) */
+#define RCC_CFGR_USBPRE (1U << 22)
+
+/* ACR register fields */
+/** Flash latency mask */
+#define FLASH_ACR_LATENCY_MASK (7U)
+
+/** Prefetch buffer enable bit */
+#define FLASH_ACR_PRFTBE (1U << 4)
+
+/** Highest SYSCLK frequency for each number of flash wait states */
+#define FLASH_WAIT_STATE_FREQ (24000000U)
+
+/** USB clock frequency in Hz */
+#define RCC_USB_FREQ (48000000U)
+
+/** Minimum external oscillator frequency in Hz */
+#define RCC_MIN_HSE_FREQ (4000000U)
+
+/** Maximum external oscillator frequency in Hz */
+#define RCC_MAX_HSE_FREQ (16000000U)
+
+/** Minimum PLL multiplication factor */
+#define RCC_MIN_PLLMUL (2)
+
+/** Maximum PLL multiplication factor */
+#define RCC_MAX_PLLMUL (16)
+
+/** Number of polling iterations before giving up on a clock to start */
+#define RCC_TIMEOUT (0x10000)
+
+/** Pointer used to access the RCC */
+static volatile rcc_regs *rcc = (volatile rcc_regs *)SOC_RCC_BASE;
+
+/** Pointer used to access the flash interface */
+static volatile flash_regs *flash = (volatile flash_regs *)SOC_FLITF_BASE;
+
+/** Current SYSCLK frequency (internal oscillator after reset) */
+static unsigned int sysclk_freq = RCC_HSI_FREQ;
+
+/** Current APB1 clock frequency */
+static unsigned int pclk1_freq = RCC_HSI_FREQ;
+
+/** Current ADC clock frequency (ADC prescaler is 2 after reset) */
+static unsigned int adcclk_freq = RCC_HSI_FREQ / 2;
+
+/**
+ * Wait for bits of a register to reach a value
+ * \param[in] reg The register to poll
+ * \param[in] mask The bits to check
+ * \param[in] val The expected value of the bits
+ * \retval 0 Success
+ * \retval #ETIMEDOUT The bits did not reach the value in time
+ */
+static int wait_bits(volatile uint32_t *reg, uint32_t mask, uint32_t val)
+{
+	unsigned int i;
+
+	for(i = 0; i < RCC_TIMEOUT; i++)
+	{
+		if((*reg & mask) == val)
+		{
+			return 0;
+		}
+	}
+
+	return ETIMEDOUT;
+}
+
+/**
+ * Run from the internal oscillator with undivided bus clocks, and stop the PLL
+ * and the external oscillator
+ */
+static void use_hsi(void)
+{
+	rcc->cfgr &= ~(RCC_CFGR_SW_MASK | RCC_CFGR_HPRE_MASK |
+	               RCC_CFGR_PPRE1_MASK | RCC_CFGR_PPRE2_MASK |
+	               RCC_CFGR_ADCPRE_MASK);
+	wait_bits(&rcc->cfgr, RCC_CFGR_SWS_MASK, RCC_CFGR_SWS_HSI);
+	rcc->cr &= ~(RCC_CR_PLLON | RCC_CR_HSEON);
+
+	sysclk_freq = RCC_HSI_FREQ;
+	pclk1_freq = RCC_HSI_FREQ;
+	adcclk_freq = RCC_HSI_FREQ / 2;
+}
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+int rcc_setup(unsigned int hse_freq, unsigned int sysclk)
+{
+	unsigned int mul, pclk1, adcdiv;
+	uint32_t cfgr;
+
+	if((hse_freq < RCC_MIN_HSE_FREQ) || (hse_freq > RCC_MAX_HSE_FREQ) ||
+	   (sysclk > RCC_MAX_SYSCLK_FREQ) || (sysclk % hse_freq))
+	{
+		return EINVAL;
+	}
+
+	mul = sysclk / hse_freq;
+	if((mul < RCC_MIN_PLLMUL) || (mul > RCC_MAX_PLLMUL))
+	{
+		return EINVAL;
+	}
+
+	/* Run from the internal oscillator while the PLL is reconfigured */
+	use_hsi();
+
+	/* Start the external oscillator */
+	rcc->cr |= RCC_CR_HSEON;
+	if(wait_bits(&rcc->cr, RCC_CR_HSERDY, RCC_CR_HSERDY) != 0)
+	{
+		use_hsi();
+		return ETIMEDOUT;
+	}
+
+	/* Keep APB1 and the ADC clock within their limits */
+	cfgr = rcc->cfgr & ~(RCC_CFGR_PLLSRC_HSE | RCC_CFGR_PLLXTPRE |
+	                     RCC_CFGR_PLLMUL_MASK | RCC_CFGR_USBPRE);
+	pclk1 = sysclk;
+	if(pclk1 > RCC_MAX_PCLK1_FREQ)
+	{
+		cfgr |= RCC_CFGR_PPRE1_DIV_2;
+		pclk1 /= 2;
+	}
+
+	/* ADC prescaler field selects a division by 2, 4, 6 or 8 */
+	for(adcdiv = 2; adcdiv < 8; adcdiv += 2)
+	{
+		if(sysclk / adcdiv <= RCC_MAX_ADCCLK_FREQ)
+		{
+			break;
+		}
+	}
+	cfgr |= ((adcdiv / 2) - 1) << RCC_CFGR_ADCPRE_SHIFT;
+
+	/* USB needs 48 MHz, from the PLL output either divided by 1.5 or not */
+	if(sysclk == RCC_USB_FREQ)
+	{
+		cfgr |= RCC_CFGR_USBPRE;
+	}
+
+	/* Configure and start the PLL */
+	cfgr |= RCC_CFGR_PLLSRC_HSE |
+	        ((mul - RCC_MIN_PLLMUL) << RCC_CFGR_PLLMUL_SHIFT);
+	rcc->cfgr = cfgr;
+	rcc->cr |= RCC_CR_PLLON;
+	if(wait_bits(&rcc->cr, RCC_CR_PLLRDY, RCC_CR_PLLRDY) != 0)
+	{
+		use_hsi();
+		return ETIMEDOUT;
+	}
+
+	/* Flash needs one wait state per 24 MHz step before switching */
+	flash->acr = (flash->acr & ~FLASH_ACR_LATENCY_MASK) | FLASH_ACR_PRFTBE |
+	             ((sysclk - 1) / FLASH_WAIT_STATE_FREQ);
+
+	/* Switch to the PLL */
+	rcc->cfgr = (cfgr & ~RCC_CFGR_SW_MASK) | RCC_CFGR_SW_PLL;
+	if(wait_bits(&rcc->cfgr, RCC_CFGR_SWS_MASK, RCC_CFGR_SWS_PLL) != 0)
+	{
+		use_hsi();
+		return ETIMEDOUT;
+	}
+
+	sysclk_freq = sysclk;
+	pclk1_freq = pclk1;
+	adcclk_freq = sysclk / adcdiv;
+
+	return 0;
+}
+
+unsigned int rcc_get_sysclk_freq(void)
+{
+	return sysclk_freq;
+}
+
+unsigned int rcc_get_hclk_freq(void)
+{
+	/* AHB is not divided */
+	return sysclk_freq;
+}
+
+unsigned int rcc_get_pclk1_freq(void)
+{
+	return pclk1_freq;
+}
+
+unsigned int rcc_get_pclk2_freq(void)
+{
+	/* APB2 is not divided */
+	return sysclk_freq;
+}
+
+unsigned int rcc_get_adcclk_freq(void)
+{
+	return adcclk_freq;
+}
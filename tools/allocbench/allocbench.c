@@ -0,0 +1,809 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file allocbench.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Host harness for the kernel allocator and lists
+ *
+ * The kernel allocator is built for the host, against a heap array, and fed
+ * with workloads: synthetic patterns or allocation traces recorded on the
+ * target (see tools/trace2kalloc.py). Each workload reports the time per
+ * operation, the peak fragmentation and the failure rate. Allocated blocks
+ * are filled and checked on release, so that overlapping blocks are caught.
+ *
+ * Usage: allocbench [-j] [-h heap_size] [-n nb_ops] [-s seed] workload...
+ * where a workload is fixed, bimodal, lifo, random, list, or a trace file.
+ *
+ * Trace files hold one operation per line, '#' starts a comment:
+ *   a <id> <size>    allocation of size bytes, identified by id
+ *   f <id>           release of the block allocated with id
+ * Ids are numbers (e.g. the addresses returned on the target), they can be
+ * reused once released. Releases of unknown ids are ignored, so that traces
+ * can start in the middle of a run.
+ */
+/* Kernel headers first, the C library ones redefine what they share */
+#include <cpu/cpu_utils.h>
+#include <kernel/kalloc.h>
+#include <kernel/list.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*******************************************************************************
+ * Private definitions
+ ******************************************************************************/
+/** Default heap size in bytes, close to what is left on the target */
+#define DEFAULT_HEAP_SIZE (16 * 1024)
+
+/** Default number of operations of synthetic workloads */
+#define DEFAULT_NB_OPS (100000)
+
+/** Maximum number of blocks kept alive by synthetic workloads */
+#define MAX_LIVE (64)
+
+/** Release of an unknown id, skipped on replay */
+#define SLOT_NONE ((size_t)-1)
+
+/** Workload operation */
+typedef struct
+{
+	char type;              /**< 'a' for kmalloc, 'f' for kfree */
+	size_t slot;            /**< Slot holding the block */
+	size_t size;            /**< Allocation size in bytes */
+} operation;
+
+/** Workload, a sequence of operations on numbered slots */
+typedef struct
+{
+	const char *name;       /**< Workload name */
+	operation *ops;         /**< Operations */
+	size_t nb_ops;          /**< Number of operations */
+	size_t max_ops;         /**< Capacity of ops */
+	size_t nb_slots;        /**< Number of slots used by the operations */
+} workload;
+
+/** Replay results */
+typedef struct
+{
+	unsigned long nb_alloc;         /**< Number of kmalloc calls */
+	unsigned long nb_free;          /**< Number of kfree calls */
+	unsigned long nb_fail;          /**< Number of failed kmalloc calls */
+	double alloc_ns;                /**< Total time spent in kmalloc */
+	double free_ns;                 /**< Total time spent in kfree */
+	double max_alloc_ns;            /**< Longest kmalloc call */
+	double max_free_ns;             /**< Longest kfree call */
+	unsigned int peak_frag;         /**< Peak fragmentation in permille */
+	size_t peak_used;               /**< Peak number of heap bytes used */
+	size_t leaked;                  /**< Bytes not returned to the heap */
+} results;
+
+/** Heap array managed by the kernel allocator */
+static unsigned char *heap;
+
+/** Size of the heap array in bytes */
+static size_t heap_size = DEFAULT_HEAP_SIZE;
+
+/** Number of operations of synthetic workloads */
+static size_t nb_ops = DEFAULT_NB_OPS;
+
+/** State of the pseudo-random generator, identical on all hosts */
+static unsigned long long rand_state = 1;
+
+/** True to print results as JSON lines */
+static int json;
+
+/**
+ * Get a pseudo-random number (xorshift64*)
+ * \param[in] n Upper bound
+ * \return A number in [0, n)
+ */
+static size_t rand_below(size_t n)
+{
+	rand_state ^= rand_state >> 12;
+	rand_state ^= rand_state << 25;
+	rand_state ^= rand_state >> 27;
+
+	return ((rand_state * 2685821657736338717ULL) >> 32) % n;
+}
+
+/**
+ * Get a pseudo-random number in a range
+ * \param[in] min Lowest value
+ * \param[in] max Highest value
+ * \return A number in [min, max]
+ */
+static size_t rand_range(size_t min, size_t max)
+{
+	return min + rand_below(max - min + 1);
+}
+
+/**
+ * Get the time of the monotonic clock
+ * \return Time in nanoseconds
+ */
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (ts.tv_sec * 1e9) + ts.tv_nsec;
+}
+
+/**
+ * Append an operation to a workload
+ * \param[in,out] w The workload
+ * \param[in] type 'a' for kmalloc, 'f' for kfree
+ * \param[in] slot Slot holding the block
+ * \param[in] size Allocation size in bytes
+ */
+static void add_op(workload *w, char type, size_t slot, size_t size)
+{
+	if(w->nb_ops == w->max_ops)
+	{
+		w->max_ops = w->max_ops ? (w->max_ops * 2) : 1024;
+		w->ops = realloc(w->ops, w->max_ops * sizeof(*w->ops));
+		if(w->ops == NULL)
+		{
+			perror("realloc");
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	w->ops[w->nb_ops].type = type;
+	w->ops[w->nb_ops].slot = slot;
+	w->ops[w->nb_ops].size = size;
+	w->nb_ops++;
+
+	if((slot != SLOT_NONE) && (slot >= w->nb_slots))
+		w->nb_slots = slot + 1;
+}
+
+/*
+ * Synthetic workloads. Each allocation uses a new slot, blocks still alive at
+ * the end are released so that leaks show up.
+ */
+
+/** Allocation size generator of synthetic workloads */
+typedef size_t (*size_generator)(void);
+
+/** Blocks of a single size */
+static size_t size_fixed(void)
+{
+	return 32;
+}
+
+/** Mostly small blocks, with a few large buffers */
+static size_t size_bimodal(void)
+{
+	return (rand_below(10) == 0) ? rand_range(512, 2048) :
+	                               rand_range(16, 64);
+}
+
+/** Small to medium blocks */
+static size_t size_small(void)
+{
+	return rand_range(8, 256);
+}
+
+/** Blocks of any size */
+static size_t size_random(void)
+{
+	return rand_range(8, 1024);
+}
+
+/**
+ * Generate a workload releasing blocks in random order
+ * \param[out] w The workload
+ * \param[in] size Allocation size generator
+ */
+static void gen_random_order(workload *w, size_generator size)
+{
+	size_t live[MAX_LIVE];
+	size_t nb_live = 0, slot = 0, i;
+
+	while(w->nb_ops < nb_ops)
+	{
+		if((nb_live == 0) ||
+		   ((nb_live < MAX_LIVE) && (rand_below(2) == 0)))
+		{
+			add_op(w, 'a', slot, size());
+			live[nb_live++] = slot++;
+		}
+		else
+		{
+			i = rand_below(nb_live);
+			add_op(w, 'f', live[i], 0);
+			live[i] = live[--nb_live];
+		}
+	}
+
+	while(nb_live > 0)
+		add_op(w, 'f', live[--nb_live], 0);
+}
+
+/**
+ * Generate a workload releasing the most recent block first
+ * \param[out] w The workload
+ */
+static void gen_lifo(workload *w)
+{
+	size_t live[MAX_LIVE];
+	size_t nb_live = 0, slot = 0;
+
+	while(w->nb_ops < nb_ops)
+	{
+		if((nb_live == 0) ||
+		   ((nb_live < MAX_LIVE) && (rand_below(2) == 0)))
+		{
+			add_op(w, 'a', slot, size_small());
+			live[nb_live++] = slot++;
+		}
+		else
+		{
+			add_op(w, 'f', live[--nb_live], 0);
+		}
+	}
+
+	while(nb_live > 0)
+		add_op(w, 'f', live[--nb_live], 0);
+}
+
+/**
+ * Generate a workload where each block lives for a random number of
+ * operations, so that short and long lived blocks interleave
+ * \param[out] w The workload
+ */
+static void gen_lifetimes(workload *w)
+{
+	size_t live[MAX_LIVE], expiry[MAX_LIVE];
+	size_t nb_live = 0, slot = 0, step, i;
+
+	for(step = 0; w->nb_ops < nb_ops; step++)
+	{
+		/* Release expired blocks */
+		for(i = 0; i < nb_live; )
+		{
+			if(expiry[i] <= step)
+			{
+				add_op(w, 'f', live[i], 0);
+				nb_live--;
+				live[i] = live[nb_live];
+				expiry[i] = expiry[nb_live];
+			}
+			else
+			{
+				i++;
+			}
+		}
+
+		if(nb_live < MAX_LIVE)
+		{
+			add_op(w, 'a', slot, size_random());
+			live[nb_live] = slot++;
+			/* Mostly short lives, some blocks stay much longer */
+			expiry[nb_live] = step + ((rand_below(8) == 0) ?
+			                          rand_range(64, 1024) :
+			                          rand_range(1, 16));
+			nb_live++;
+		}
+	}
+
+	while(nb_live > 0)
+		add_op(w, 'f', live[--nb_live], 0);
+}
+
+/** Entry of the id to slot table used to load traces */
+typedef struct
+{
+	unsigned long id;       /**< Recorded id */
+	size_t slot;            /**< Slot of the live block, or SLOT_NONE */
+	int used;               /**< True if the entry holds an id */
+} id_entry;
+
+/**
+ * Find the entry of an id, or the free entry where to insert it
+ * \param[in] table The table, with a power of 2 number of entries
+ * \param[in] mask Number of entries minus 1
+ * \param[in] id The id to look for
+ * \return The entry
+ */
+static id_entry *find_id(id_entry *table, size_t mask, unsigned long id)
+{
+	size_t i = (id * 0x9E3779B97F4A7C15ULL) & mask;
+
+	while(table[i].used && (table[i].id != id))
+		i = (i + 1) & mask;
+
+	return &table[i];
+}
+
+/**
+ * Load a recorded allocation trace
+ * \param[out] w The workload
+ * \param[in] path Path of the trace file
+ * \retval 0 Success
+ * \retval -1 The file cannot be read
+ */
+static int load_trace(workload *w, const char *path)
+{
+	id_entry *table;
+	id_entry *e;
+	size_t mask = 0xFFFF, nb_ids = 0, slot = 0, i;
+	unsigned long id, size;
+	char line[128];
+	char type;
+	FILE *f;
+
+	f = fopen(path, "r");
+	if(f == NULL)
+	{
+		perror(path);
+		return -1;
+	}
+
+	table = calloc(mask + 1, sizeof(*table));
+	if(table == NULL)
+	{
+		perror("calloc");
+		exit(EXIT_FAILURE);
+	}
+
+	while(fgets(line, sizeof(line), f) != NULL)
+	{
+		if(sscanf(line, " %c %li %lu", &type, &id, &size) < 2)
+			continue;
+		if((type != 'a') && (type != 'f'))
+			continue;
+
+		e = find_id(table, mask, id);
+		if(!e->used)
+		{
+			/* Keep the table at most half full */
+			if(++nb_ids > (mask + 1) / 2)
+			{
+				fprintf(stderr, "%s: too many ids\n", path);
+				exit(EXIT_FAILURE);
+			}
+			e->used = 1;
+			e->id = id;
+			e->slot = SLOT_NONE;
+		}
+
+		if(type == 'a')
+		{
+			/* A live id allocated again lost its release */
+			if(e->slot != SLOT_NONE)
+				add_op(w, 'f', e->slot, 0);
+			e->slot = slot++;
+			add_op(w, 'a', e->slot, size);
+		}
+		else
+		{
+			add_op(w, 'f', e->slot, 0);
+			e->slot = SLOT_NONE;
+		}
+	}
+
+	fclose(f);
+
+	/* Traces do not release what is alive at the end, do it here */
+	for(i = 0; i <= mask; i++)
+	{
+		if(table[i].used && (table[i].slot != SLOT_NONE))
+			add_op(w, 'f', table[i].slot, 0);
+	}
+
+	free(table);
+
+	return 0;
+}
+
+/**
+ * Update the peak usage and fragmentation after an operation
+ * \param[in,out] r The results
+ */
+static void sample_heap(results *r)
+{
+	kalloc_stats stats;
+	unsigned int frag;
+	size_t used;
+
+	kalloc_get_stats(&stats);
+
+	used = heap_size - stats.free_bytes;
+	if(used > r->peak_used)
+		r->peak_used = used;
+
+	/* Share of the free memory unusable by a request for all of it */
+	if(stats.free_bytes != 0)
+	{
+		frag = 1000 - ((stats.largest_free * 1000) / stats.free_bytes);
+		if(frag > r->peak_frag)
+			r->peak_frag = frag;
+	}
+}
+
+/**
+ * Fill pattern of the block of a slot
+ * \param[in] slot The slot
+ * \return The byte filling the block
+ */
+static unsigned char slot_pattern(size_t slot)
+{
+	return (unsigned char)((slot * 31) + 7);
+}
+
+/**
+ * Check that a block still holds its fill pattern
+ * \param[in] p The block
+ * \param[in] size Size of the block
+ * \param[in] slot Slot holding the block
+ * \retval 1 The block is intact
+ * \retval 0 The block was overwritten
+ */
+static int check_block(const unsigned char *p, size_t size, size_t slot)
+{
+	size_t i;
+
+	for(i = 0; i < size; i++)
+	{
+		if(p[i] != slot_pattern(slot))
+			return 0;
+	}
+
+	return 1;
+}
+
+/**
+ * Replay a workload on a fresh heap
+ * \param[in] w The workload
+ * \param[out] r The results
+ * \retval 0 Success
+ * \retval -1 The allocator corrupted a block
+ */
+static int replay(const workload *w, results *r)
+{
+	const operation *op;
+	unsigned char **blocks;
+	size_t *sizes;
+	kalloc_stats stats;
+	double start, t;
+	size_t initial_free, i;
+	int ret = 0;
+	void *p;
+
+	memset(r, 0, sizeof(*r));
+
+	blocks = calloc(w->nb_slots + 1, sizeof(*blocks));
+	sizes = calloc(w->nb_slots + 1, sizeof(*sizes));
+	if((blocks == NULL) || (sizes == NULL))
+	{
+		perror("calloc");
+		exit(EXIT_FAILURE);
+	}
+
+	kalloc_init(heap, heap_size);
+	kalloc_get_stats(&stats);
+	initial_free = stats.free_bytes;
+
+	for(i = 0; i < w->nb_ops; i++)
+	{
+		op = &w->ops[i];
+
+		if(op->type == 'a')
+		{
+			start = now_ns();
+			p = kmalloc(op->size);
+			t = now_ns() - start;
+
+			r->nb_alloc++;
+			r->alloc_ns += t;
+			if(t > r->max_alloc_ns)
+				r->max_alloc_ns = t;
+
+			if(p == NULL)
+			{
+				r->nb_fail++;
+				continue;
+			}
+
+			blocks[op->slot] = p;
+			sizes[op->slot] = op->size;
+			memset(p, slot_pattern(op->slot), op->size);
+		}
+		else
+		{
+			if(op->slot == SLOT_NONE)
+				continue;
+			if(blocks[op->slot] == NULL)
+				continue;
+
+			p = blocks[op->slot];
+			if(!check_block(p, sizes[op->slot], op->slot))
+			{
+				fprintf(stderr, "%s: block of operation %zu "
+				        "overwritten\n", w->name, i);
+				ret = -1;
+				break;
+			}
+
+			start = now_ns();
+			kfree(p);
+			t = now_ns() - start;
+
+			blocks[op->slot] = NULL;
+			r->nb_free++;
+			r->free_ns += t;
+			if(t > r->max_free_ns)
+				r->max_free_ns = t;
+		}
+
+		sample_heap(r);
+	}
+
+	/* Everything was released, the heap must be as after initialization */
+	kalloc_get_stats(&stats);
+	r->leaked = initial_free - stats.free_bytes;
+	if((ret == 0) && (stats.nb_blocks != 1))
+	{
+		fprintf(stderr, "%s: %u blocks left, free blocks not merged\n",
+		        w->name, stats.nb_blocks);
+		ret = -1;
+	}
+
+	free(blocks);
+	free(sizes);
+
+	return ret;
+}
+
+/**
+ * Print the results of a workload
+ * \param[in] w The workload
+ * \param[in] r The results
+ */
+static void print_results(const workload *w, const results *r)
+{
+	double alloc_avg, free_avg, fail_rate;
+
+	alloc_avg = r->nb_alloc ? (r->alloc_ns / r->nb_alloc) : 0;
+	free_avg = r->nb_free ? (r->free_ns / r->nb_free) : 0;
+	fail_rate = r->nb_alloc ? ((100.0 * r->nb_fail) / r->nb_alloc) : 0;
+
+	if(json)
+	{
+		printf("{\"workload\":\"%s\",\"allocs\":%lu,\"frees\":%lu,"
+		       "\"alloc_ns\":%.1f,\"alloc_max_ns\":%.0f,"
+		       "\"free_ns\":%.1f,\"free_max_ns\":%.0f,"
+		       "\"peak_frag_permille\":%u,\"peak_used\":%zu,"
+		       "\"fail_percent\":%.2f,\"leaked\":%zu}\n",
+		       w->name, r->nb_alloc, r->nb_free, alloc_avg,
+		       r->max_alloc_ns, free_avg, r->max_free_ns,
+		       r->peak_frag, r->peak_used, fail_rate, r->leaked);
+		return;
+	}
+
+	printf("%-12s %8lu %8lu %9.1f %9.1f %8.1f%% %9zu %7.2f%% %7zu\n",
+	       w->name, r->nb_alloc, r->nb_free, alloc_avg, free_avg,
+	       r->peak_frag / 10.0, r->peak_used, fail_rate, r->leaked);
+}
+
+/** List item of the list benchmark */
+typedef struct
+{
+	list_item node;         /**< List node */
+	size_t index;           /**< Index of the item */
+} list_object;
+
+/**
+ * Check and time list operations
+ * \param[in] nb_items Number of items in the list
+ * \retval 0 Success
+ * \retval -1 The list content is wrong
+ */
+static int bench_list(size_t nb_items)
+{
+	list_item list = LIST_INIT(list);
+	list_object *items, *obj;
+	double start, add_ns, remove_ns;
+	size_t i, count;
+
+	items = calloc(nb_items, sizeof(*items));
+	if(items == NULL)
+	{
+		perror("calloc");
+		exit(EXIT_FAILURE);
+	}
+
+	start = now_ns();
+	for(i = 0; i < nb_items; i++)
+	{
+		items[i].index = i;
+		list_add_tail(&list, &items[i].node);
+	}
+	add_ns = (now_ns() - start) / nb_items;
+
+	/* Items come back in insertion order */
+	count = 0;
+	LIST_FOR_EACH_OBJECT(obj, &list, list_object, node)
+	{
+		if(obj->index != count++)
+			return -1;
+	}
+	if(count != nb_items)
+		return -1;
+
+	/* Remove every other item, then the rest from the head */
+	start = now_ns();
+	for(i = 0; i < nb_items; i += 2)
+		list_remove(&items[i].node);
+	while(!list_is_empty(&list))
+		list_remove(list_first(&list));
+	remove_ns = (now_ns() - start) / nb_items;
+
+	free(items);
+
+	if(json)
+	{
+		printf("{\"workload\":\"list\",\"items\":%zu,\"add_ns\":%.1f,"
+		       "\"remove_ns\":%.1f}\n", nb_items, add_ns, remove_ns);
+	}
+	else
+	{
+		printf("%-12s %8zu items: add %.1f ns, remove %.1f ns\n",
+		       "list", nb_items, add_ns, remove_ns);
+	}
+
+	return 0;
+}
+
+/**
+ * Run a workload
+ * \param[in] name Synthetic workload name, or path of a trace file
+ * \retval 0 Success
+ * \retval -1 Failure
+ */
+static int run(const char *name)
+{
+	workload w = {0};
+	results r;
+	int ret = 0;
+
+	w.name = name;
+
+	if(strcmp(name, "list") == 0)
+	{
+		/* Costs must not grow with the length of the list */
+		if((bench_list(nb_ops / 100) != 0) || (bench_list(nb_ops) != 0))
+		{
+			fprintf(stderr, "list: wrong list content\n");
+			return -1;
+		}
+		return 0;
+	}
+	else if(strcmp(name, "fixed") == 0)
+		gen_random_order(&w, size_fixed);
+	else if(strcmp(name, "bimodal") == 0)
+		gen_random_order(&w, size_bimodal);
+	else if(strcmp(name, "lifo") == 0)
+		gen_lifo(&w);
+	else if(strcmp(name, "random") == 0)
+		gen_lifetimes(&w);
+	else if(load_trace(&w, name) != 0)
+		return -1;
+
+	if(replay(&w, &r) != 0)
+		ret = -1;
+	else
+		print_results(&w, &r);
+
+	free(w.ops);
+
+	return ret;
+}
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+/*
+ * The allocator masks IRQs around heap updates, the harness runs a single
+ * thread so there is nothing to mask. It plays a privileged caller.
+ */
+int cpu_irq_disable(void)
+{
+	return 0;
+}
+
+void cpu_irq_restore(int flags)
+{
+	(void)flags;
+}
+
+int cpu_is_privileged(void)
+{
+	return 1;
+}
+
+/**
+ * Harness entry point
+ * \param[in] argc Number of arguments
+ * \param[in] argv Arguments
+ * \return EXIT_SUCCESS if all workloads ran without corruption
+ */
+int main(int argc, char **argv)
+{
+	int ret = EXIT_SUCCESS;
+	int i;
+
+	for(i = 1; (i < argc) && (argv[i][0] == '-'); i++)
+	{
+		if(strcmp(argv[i], "-j") == 0)
+			json = 1;
+		else if((strcmp(argv[i], "-h") == 0) && (i + 1 < argc))
+			heap_size = strtoul(argv[++i], NULL, 0);
+		else if((strcmp(argv[i], "-n") == 0) && (i + 1 < argc))
+			nb_ops = strtoul(argv[++i], NULL, 0);
+		else if((strcmp(argv[i], "-s") == 0) && (i + 1 < argc))
+			rand_state = strtoull(argv[++i], NULL, 0) | 1;
+		else
+			break;
+	}
+
+	if((i == argc) || (nb_ops < 100))
+	{
+		fprintf(stderr, "usage: %s [-j] [-h heap_size] [-n nb_ops] "
+		        "[-s seed] fixed|bimodal|lifo|random|list|trace...\n",
+		        argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	heap = malloc(heap_size);
+	if((heap == NULL) || (kalloc_init(heap, heap_size) != 0))
+	{
+		fprintf(stderr, "cannot set up a %zu bytes heap\n", heap_size);
+		return EXIT_FAILURE;
+	}
+
+	if(!json)
+	{
+		printf("%-12s %8s %8s %9s %9s %9s %9s %8s %7s\n", "workload",
+		       "allocs", "frees", "alloc ns", "free ns", "frag",
+		       "peak", "fail", "leaked");
+	}
+
+	for(; i < argc; i++)
+	{
+		if(run(argv[i]) != 0)
+			ret = EXIT_FAILURE;
+	}
+
+	free(heap);
+
+	return ret;
+}
@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2015, Maxime Bernelas
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#     * Neither the name of the owner nor the
+#       names of its contributors may be used to endorse or promote products
+#       derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+# DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+# ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+"""Map a MOS profile dump back to functions and print a flat profile.
+
+Build with 'make PROFILE=1', run the target, then dump the histogram from GDB:
+
+    (gdb) dump binary value prof.bin prof_data
+
+and map it to the symbols of the image:
+
+    tools/prof2syms.py mos.elf prof.bin
+
+A histogram bucket may span several functions, its samples are then shared
+among them in proportion to the bytes each one covers.
+"""
+
+import argparse
+import bisect
+import struct
+import subprocess
+import sys
+
+# Must match include/kernel/prof.h
+PROF_MAGIC = 0x4652504D
+PROF_VERSION = 1
+HEADER = struct.Struct("<5I")
+RANGE = struct.Struct("<5I")
+
+
+def parse(data):
+    """Return (samples, other, ranges, buckets) from a profile dump."""
+    magic, version, samples, other, nb_ranges = HEADER.unpack_from(data)
+    if magic != PROF_MAGIC:
+        raise ValueError("bad magic, profiler was not started")
+    if version != PROF_VERSION:
+        raise ValueError("unsupported profile version %d" % version)
+
+    off = HEADER.size
+    ranges = []
+    for i in range(nb_ranges):
+        ranges.append(RANGE.unpack_from(data, off))
+        off += RANGE.size
+
+    (nb_buckets,) = struct.unpack_from("<I", data, off)
+    off += 4
+    buckets = struct.unpack_from("<%dH" % nb_buckets, data, off)
+
+    return samples, other, ranges, buckets
+
+
+def read_symbols(nm, elf):
+    """Return sorted (start, end, name) of the functions of an ELF file."""
+    out = subprocess.check_output([nm, "-S", "-n", "--defined-only", elf],
+                                  universal_newlines=True)
+    syms = []
+    for line in out.splitlines():
+        fields = line.split()
+        if len(fields) != 4 or fields[2] not in "tTwW":
+            continue
+        # Thumb function addresses have their lowest bit set
+        start = int(fields[0], 16) & ~1
+        size = int(fields[1], 16)
+        if size:
+            syms.append((start, start + size, fields[3]))
+    syms.sort()
+    return syms
+
+
+def attribute(ranges, buckets, syms):
+    """Share the samples of each bucket among the functions it covers."""
+    starts = [s[0] for s in syms]
+    profile = {}
+
+    for start, end, shift, first, nb in ranges:
+        size = 1 << shift
+        for i in range(nb):
+            count = buckets[first + i]
+            if not count:
+                continue
+
+            lo = start + i * size
+            hi = min(lo + size, end)
+            shares = []
+            j = max(bisect.bisect_right(starts, lo) - 1, 0)
+            while j < len(syms) and syms[j][0] < hi:
+                overlap = min(hi, syms[j][1]) - max(lo, syms[j][0])
+                if overlap > 0:
+                    shares.append((syms[j][2], overlap))
+                j += 1
+
+            covered = sum(o for _, o in shares)
+            if covered < hi - lo:
+                shares.append(("<unknown>", hi - lo - covered))
+            for name, overlap in shares:
+                profile[name] = (profile.get(name, 0.0) +
+                                 count * overlap / (hi - lo))
+
+    return profile
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="firmware image with symbols")
+    parser.add_argument("dump", help="raw dump of prof_data")
+    parser.add_argument("--nm", default="arm-none-eabi-nm",
+                        help="nm program (default: %(default)s)")
+    args = parser.parse_args(argv[1:])
+
+    with open(args.dump, "rb") as f:
+        data = f.read()
+
+    try:
+        samples, other, ranges, buckets = parse(data)
+    except (ValueError, struct.error) as e:
+        sys.stderr.write("%s: %s\n" % (args.dump, e))
+        return 1
+
+    profile = attribute(ranges, buckets, read_symbols(args.nm, args.elf))
+    if other:
+        profile["<outside code ranges>"] = float(other)
+
+    print("%d samples" % samples)
+    print("%10s %7s  %s" % ("samples", "%", "function"))
+    for name, count in sorted(profile.items(), key=lambda p: -p[1]):
+        pct = 100.0 * count / samples if samples else 0.0
+        print("%10.1f %6.2f%%  %s" % (count, pct, name))
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
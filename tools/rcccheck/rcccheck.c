@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2015, Maxime Bernelas
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the owner nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file rcccheck.c
+ * \author Maxime Bernelas <maxime@bernelas.fr>
+ * Host check of the clock driver
+ *
+ * The driver is built for the host with its register pointers redirected to
+ * memory blocks standing for the RCC and the flash interface. Memory does not
+ * react to writes, so the ready and switch status bits are preset to what the
+ * hardware would report: all set for a clock that starts, left clear for one
+ * that does not. Each case checks the return value, the resulting CFGR, CR
+ * and ACR values and the published frequencies against values worked out
+ * from the reference manual (RM0008).
+ */
+/* The driver first, the C library headers redefine what they share */
+#include "../../src/soc/rcc.c"
+#include <stdio.h>
+#include <string.h>
+
+/*******************************************************************************
+ * Private definitions
+ ******************************************************************************/
+/** CR value after reset: internal oscillator on and ready, default trim */
+#define CR_RESET (0x00000083U)
+
+/** ACR value after reset: prefetch buffer enabled and on */
+#define ACR_RESET (0x00000030U)
+
+/** CR status bits preset when the clocks start */
+#define CR_READY (RCC_CR_HSERDY | RCC_CR_PLLRDY)
+
+/** CR value once both clocks are on and ready */
+#define CR_PLL (CR_RESET | CR_READY | RCC_CR_HSEON | RCC_CR_PLLON)
+
+/** CFGR PLL fields: factor minus 2 at bit 18, HSE source at bit 16 */
+#define CFGR_PLL(mul) ((((mul) - 2U) << 18) | (1U << 16))
+
+/** CFGR ADC prescaler field: divider / 2 - 1 at bit 14 */
+#define CFGR_ADC(div) ((((div) / 2U) - 1U) << 14)
+
+/** CFGR APB1 prescaler field for a division by 2 */
+#define CFGR_APB1_2 (4U << 8)
+
+/** CFGR USB prescaler bit, set for an undivided PLL output */
+#define CFGR_USB (1U << 22)
+
+/** CFGR clock switch field selecting the PLL */
+#define CFGR_SW_PLL (2U)
+
+/** Frequencies after reset: SYSCLK, HCLK, PCLK1, PCLK2, ADCCLK */
+#define FREQ_RESET {8000000, 8000000, 8000000, 8000000, 4000000}
+
+/** Expected outcome of a rcc_setup() call */
+typedef struct
+{
+	const char *name;       /**< Name of the case */
+	unsigned int hse;       /**< External oscillator frequency */
+	unsigned int sysclk;    /**< Requested SYSCLK frequency */
+	uint32_t cr_status;     /**< CR status bits of the stand-in */
+	uint32_t cfgr_status;   /**< CFGR switch status of the stand-in */
+	int ret;                /**< Expected return value */
+	uint32_t cr;            /**< Expected CR value */
+	uint32_t cfgr;          /**< Expected CFGR value, without status */
+	uint32_t acr;           /**< Expected ACR value */
+	unsigned int freq[5];   /**< Expected frequencies, as FREQ_RESET */
+} rcc_case;
+
+/** Test cases */
+static const rcc_case cases[] =
+{
+	{
+		"72 MHz from 8 MHz", 8000000, 72000000,
+		CR_READY, RCC_CFGR_SWS_PLL, 0, CR_PLL,
+		CFGR_PLL(9) | CFGR_ADC(6) | CFGR_APB1_2 | CFGR_SW_PLL, 0x32,
+		{72000000, 72000000, 36000000, 72000000, 12000000}
+	},
+	{
+		"48 MHz from 8 MHz", 8000000, 48000000,
+		CR_READY, RCC_CFGR_SWS_PLL, 0, CR_PLL,
+		CFGR_USB | CFGR_PLL(6) | CFGR_ADC(4) | CFGR_APB1_2 |
+		CFGR_SW_PLL, 0x31,
+		{48000000, 48000000, 24000000, 48000000, 12000000}
+	},
+	{
+		"24 MHz from 12 MHz", 12000000, 24000000,
+		CR_READY, RCC_CFGR_SWS_PLL, 0, CR_PLL,
+		CFGR_PLL(2) | CFGR_ADC(2) | CFGR_SW_PLL, 0x30,
+		{24000000, 24000000, 24000000, 24000000, 12000000}
+	},
+	{
+		"above 72 MHz", 8000000, 80000000,
+		CR_READY, RCC_CFGR_SWS_PLL, EINVAL, CR_RESET | CR_READY,
+		0, ACR_RESET, FREQ_RESET
+	},
+	{
+		"not a multiple", 8000000, 60000000,
+		CR_READY, RCC_CFGR_SWS_PLL, EINVAL, CR_RESET | CR_READY,
+		0, ACR_RESET, FREQ_RESET
+	},
+	{
+		"oscillator timeout", 8000000, 72000000,
+		0, RCC_CFGR_SWS_HSI, ETIMEDOUT, CR_RESET,
+		0, ACR_RESET, FREQ_RESET
+	},
+	{
+		"PLL timeout", 8000000, 72000000,
+		RCC_CR_HSERDY, RCC_CFGR_SWS_HSI, ETIMEDOUT,
+		CR_RESET | RCC_CR_HSERDY, CFGR_PLL(9), ACR_RESET, FREQ_RESET
+	},
+};
+
+/** Stand-in for the RCC registers */
+static rcc_regs fake_rcc;
+
+/** Stand-in for the flash interface registers */
+static flash_regs fake_flash;
+
+/**
+ * Put the stand-in and the driver back in their reset state
+ * \param[in] c The case giving the status bits to preset
+ */
+static void reset(const rcc_case *c)
+{
+	memset(&fake_rcc, 0, sizeof(fake_rcc));
+	memset(&fake_flash, 0, sizeof(fake_flash));
+	fake_rcc.cr = CR_RESET | c->cr_status;
+	fake_rcc.cfgr = c->cfgr_status;
+	fake_flash.acr = ACR_RESET;
+
+	rcc = &fake_rcc;
+	flash = &fake_flash;
+	sysclk_freq = RCC_HSI_FREQ;
+	pclk1_freq = RCC_HSI_FREQ;
+	adcclk_freq = RCC_HSI_FREQ / 2;
+}
+
+/**
+ * Compare a value with the expected one and report a mismatch
+ * \param[in] c The case being run
+ * \param[in] what Name of the value
+ * \param[in] got The value
+ * \param[in] exp The expected value
+ * \return 1 on mismatch, 0 otherwise
+ */
+static int check(const rcc_case *c, const char *what, unsigned int got,
+                 unsigned int exp)
+{
+	if(got == exp)
+	{
+		return 0;
+	}
+
+	printf("%s: %s is 0x%08x, expected 0x%08x\n", c->name, what, got, exp);
+	return 1;
+}
+
+/*******************************************************************************
+ * Public functions
+ ******************************************************************************/
+int main(void)
+{
+	unsigned int i, errors = 0;
+	const rcc_case *c;
+	int ret;
+
+	for(i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+	{
+		c = &cases[i];
+		reset(c);
+		ret = rcc_setup(c->hse, c->sysclk);
+
+		errors += check(c, "return value", ret, c->ret);
+		errors += check(c, "CR", fake_rcc.cr, c->cr);
+		errors += check(c, "CFGR", fake_rcc.cfgr & ~RCC_CFGR_SWS_MASK,
+		                c->cfgr);
+		errors += check(c, "ACR", fake_flash.acr, c->acr);
+		errors += check(c, "SYSCLK", rcc_get_sysclk_freq(), c->freq[0]);
+		errors += check(c, "HCLK", rcc_get_hclk_freq(), c->freq[1]);
+		errors += check(c, "PCLK1", rcc_get_pclk1_freq(), c->freq[2]);
+		errors += check(c, "PCLK2", rcc_get_pclk2_freq(), c->freq[3]);
+		errors += check(c, "ADCCLK", rcc_get_adcclk_freq(), c->freq[4]);
+	}
+
+	printf("%u cases, %u mismatches\n", i, errors);
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2015, Maxime Bernelas
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#     * Neither the name of the owner nor the
+#       names of its contributors may be used to endorse or promote products
+#       derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+# DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+# ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+"""Convert a MOS trace buffer dump to Chrome/Perfetto trace JSON.
+
+Build with 'make TRACE=1', run the target, then dump the buffer from GDB:
+
+    (gdb) dump binary value trace.bin trace_buffer
+
+and convert it:
+
+    tools/trace2json.py trace.bin > trace.json
+
+The result opens in https://ui.perfetto.dev or chrome://tracing.
+"""
+
+import json
+import struct
+import sys
+
+# Must match include/kernel/trace.h
+TRACE_MAGIC = 0x4352544D
+TRACE_VERSION = 1
+HEADER = struct.Struct("<5I")
+EVENT = struct.Struct("<IIHHI")
+
+TRACE_SWITCH = 1
+TRACE_IRQ_ENTER = 2
+TRACE_IRQ_EXIT = 3
+TRACE_SVC_ENTER = 4
+TRACE_SVC_EXIT = 5
+TRACE_ALLOC = 6
+TRACE_FREE = 7
+
+# Thread id of the IRQ track, tasks use their descriptor address
+IRQ_TID = 0
+PID = 1
+
+
+def parse(data):
+    """Return (freq, events) with events sorted in recording order."""
+    if len(data) < HEADER.size:
+        raise ValueError("dump is too short")
+
+    magic, version, nb_events, freq, head = HEADER.unpack_from(data)
+    if magic != TRACE_MAGIC:
+        raise ValueError("bad magic, tracing was not started")
+    if version != TRACE_VERSION:
+        raise ValueError("unsupported trace version %d" % version)
+    if len(data) < HEADER.size + nb_events * EVENT.size:
+        raise ValueError("dump is truncated")
+
+    events = []
+    for i in range(nb_events):
+        seq, ts, etype, arg0, arg1 = EVENT.unpack_from(
+            data, HEADER.size + i * EVENT.size)
+        # Skip partial records and records overwritten during the dump
+        if seq == 0 or seq > head or seq + nb_events <= head:
+            continue
+        events.append((seq, ts, etype, arg0, arg1))
+
+    events.sort()
+    return freq, events
+
+
+def unwrap(events):
+    """Extend 32-bit timestamps, tolerating slightly out of order ones."""
+    last = None
+    base = 0
+    for seq, ts, etype, arg0, arg1 in events:
+        if last is None:
+            base = ts
+        else:
+            delta = (ts - last) & 0xFFFFFFFF
+            if delta >= 0x80000000:
+                delta -= 0x100000000
+            base += delta
+        last = ts
+        yield base, etype, arg0, arg1
+
+
+def convert(freq, events):
+    out = []
+    tasks = set()
+    current = None
+    start = None
+
+    def us(cycles):
+        return (cycles - start) * 1e6 / freq
+
+    def emit(ph, name, tid, t, args=None):
+        e = {"ph": ph, "name": name, "pid": PID, "tid": tid, "ts": us(t)}
+        if ph == "i":
+            e["s"] = "t"
+        if args:
+            e["args"] = args
+        out.append(e)
+
+    for t, etype, arg0, arg1 in unwrap(events):
+        if start is None:
+            start = t
+
+        if etype == TRACE_SWITCH:
+            if current is not None:
+                emit("E", "running", current, t)
+            current = arg1
+            tasks.add(current)
+            emit("B", "running", current, t)
+        elif etype == TRACE_IRQ_ENTER:
+            emit("B", "IRQ %d" % arg0, IRQ_TID, t)
+        elif etype == TRACE_IRQ_EXIT:
+            emit("E", "IRQ %d" % arg0, IRQ_TID, t)
+        elif etype == TRACE_SVC_ENTER and current is not None:
+            emit("B", "svc %d" % arg0, current, t)
+        elif etype == TRACE_SVC_EXIT and current is not None:
+            emit("E", "svc %d" % arg0, current, t, {"ret": arg1})
+        elif etype in (TRACE_ALLOC, TRACE_FREE):
+            tid = current if current is not None else IRQ_TID
+            if etype == TRACE_ALLOC:
+                emit("i", "kmalloc", tid, t,
+                     {"size": arg0, "addr": "0x%08x" % arg1})
+            else:
+                emit("i", "kfree", tid, t, {"addr": "0x%08x" % arg1})
+
+    meta = [{"ph": "M", "name": "process_name", "pid": PID,
+             "args": {"name": "MOS"}},
+            {"ph": "M", "name": "thread_name", "pid": PID, "tid": IRQ_TID,
+             "args": {"name": "IRQs"}}]
+    for task in sorted(tasks):
+        meta.append({"ph": "M", "name": "thread_name", "pid": PID,
+                     "tid": task, "args": {"name": "task 0x%08x" % task}})
+
+    return {"traceEvents": meta + out, "displayTimeUnit": "ns"}
+
+
+def main(argv):
+    if len(argv) != 2:
+        sys.stderr.write("usage: %s DUMP\n" % argv[0])
+        return 2
+
+    with open(argv[1], "rb") as f:
+        data = f.read()
+
+    try:
+        freq, events = parse(data)
+    except ValueError as e:
+        sys.stderr.write("%s: %s\n" % (argv[1], e))
+        return 1
+
+    json.dump(convert(freq, events), sys.stdout, indent=1)
+    sys.stdout.write("\n")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2015, Maxime Bernelas
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#     * Redistributions of source code must retain the above copyright
+#       notice, this list of conditions and the following disclaimer.
+#     * Redistributions in binary form must reproduce the above copyright
+#       notice, this list of conditions and the following disclaimer in the
+#       documentation and/or other materials provided with the distribution.
+#     * Neither the name of the owner nor the
+#       names of its contributors may be used to endorse or promote products
+#       derived from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDERS BE LIABLE FOR ANY
+# DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+# ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+"""Convert the allocations of a MOS trace buffer dump to an allocbench trace.
+
+Dump the trace buffer as for tools/trace2json.py, then:
+
+    tools/trace2kalloc.py trace.bin > kalloc.trace
+    tools/allocbench/allocbench kalloc.trace
+
+Blocks are identified by the address returned on the target.
+"""
+
+import sys
+
+from trace2json import TRACE_ALLOC, TRACE_FREE, parse
+
+
+def main(argv):
+    if len(argv) != 2:
+        sys.stderr.write("usage: %s DUMP\n" % argv[0])
+        return 2
+
+    with open(argv[1], "rb") as f:
+        data = f.read()
+
+    try:
+        freq, events = parse(data)
+    except ValueError as e:
+        sys.stderr.write("%s: %s\n" % (argv[1], e))
+        return 1
+
+    sys.stdout.write("# %s\n" % argv[1])
+    for seq, ts, etype, arg0, arg1 in events:
+        if etype == TRACE_ALLOC and arg1 != 0:
+            sys.stdout.write("a 0x%08x %d\n" % (arg1, arg0))
+        elif etype == TRACE_FREE and arg1 != 0:
+            sys.stdout.write("f 0x%08x\n" % arg1)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))